@@ -1,4 +1,4 @@
-QT += core sql httpserver gui network
+QT += core sql httpserver gui network concurrent
 CONFIG += console c++17
 
 INCLUDEPATH += $$PWD/config
@@ -14,6 +14,25 @@ SOURCES += \
     backend_rfcom_fault.cpp \
     backend_stationary_health.cpp \
     backend_stationary_kavach.cpp \
+    crc32.cpp \
+    day_summary_cache.cpp \
+    db_pool.cpp \
+    fault_listing.cpp \
+    fault_rollup.cpp \
+    graph_series.cpp \
+    hex_decoder.cpp \
+    kavach_schema.cpp \
+    log_container.cpp \
+    log_index.cpp \
+    log_ingest.cpp \
+    log_parallel.cpp \
+    log_scanner.cpp \
+    log_tail.cpp \
+    loco_series_store.cpp \
+    relay_state_store.cpp \
+    response_stream.cpp \
+    route_pool.cpp \
+    sql_row_mapper.cpp \
     config/track_profile_config.cpp \
     graph_backend.cpp \
     lvk_fault_packet.cpp \
@@ -38,6 +57,28 @@ HEADERS += \
     backend_rfcom_fault.h \
     backend_stationary_health.h \
     backend_stationary_kavach.h \
+    bit_reader.h \
+    crc32.h \
+    day_cache.h \
+    day_summary_cache.h \
+    db_pool.h \
+    fault_listing.h \
+    fault_rollup.h \
+    graph_series.h \
+    hex_decoder.h \
+    kavach_schema.h \
+    log_container.h \
+    log_index.h \
+    log_ingest.h \
+    log_parallel.h \
+    log_scanner.h \
+    log_tail.h \
+    loco_series_store.h \
+    relay_state_store.h \
+    response_stream.h \
+    route_pool.h \
+    row_sink.h \
+    sql_row_mapper.h \
     config/track_profile_config.h \
     dbconfig.h \
     graph_backend.h \
@@ -45,6 +86,7 @@ HEADERS += \
     lvk_fault_parser.h \
     lvk_pos_info_packet.h \
     lvk_pos_info_parser.h \
+    lvk_pos_info_view.h \
     parameter_report_backend.h \
     track_profile_graph_backend.h \
     track_profile_report_backend.h \
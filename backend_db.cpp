@@ -3,42 +3,23 @@
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QDir>
-#include "dbconfig.h"
-// =====================================================
-// SAFE DATABASE OPENER (SQL SERVER)
-// =====================================================
-static QSqlDatabase openDatabase()
-{
-    if (QSqlDatabase::contains(DB_CONN_NAME)) {
-        return QSqlDatabase::database(DB_CONN_NAME);
-    }
-
-    QSqlDatabase db = QSqlDatabase::addDatabase("QODBC", DB_CONN_NAME);
-    db.setDatabaseName(DB_CONNECTION_STRING);
-
-    if (!db.open()) {
-        qDebug() << "DB open failed:" << db.lastError().text();
-    }
-
-    return db;
-}
+#include "db_pool.h"
 
 QJsonObject BackendDB::checkConnection()
 {
     QJsonObject result;
 
-     QSqlDatabase db = openDatabase();
+    DbConnection conn;
 
-    if (db.open()) {
+    if (conn.isValid()) {
         result["connected"] = true;
-        result["driver"] = db.driverName();
+        result["driver"] = conn.database().driverName();
         result["db"] = "SQL Server";
-        db.close();
     } else {
         result["connected"] = false;
-        result["error"] = db.lastError().text();
+        result["error"] = conn.error();
     }
 
-    QSqlDatabase::removeDatabase("health_check");
+    result["pool"] = DbPool::stats();
     return result;
 }
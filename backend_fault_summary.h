@@ -2,11 +2,15 @@
 #define BACKEND_FAULT_SUMMARY_H
 
 #include <QJsonObject>
+#include <QString>
 
 class BackendFaultSummary
 {
 public:
-    static QJsonObject getSummary();
+    // Station-wise fault counts from the daily rollup (fault_rollup.h);
+    // from / to (yyyy-MM-dd) are optional and inclusive
+    static QJsonObject getSummary(const QString &fromDate = QString(),
+                                  const QString &toDate = QString());
 };
 
 #endif // BACKEND_FAULT_SUMMARY_H
@@ -6,33 +6,19 @@
 #include <QSqlError>
 #include <QJsonArray>
 #include <iostream>
-#include "dbconfig.h"
-// =====================================================
-// SAFE DATABASE OPENER (SQL SERVER)
-// =====================================================
-static QSqlDatabase openDatabase()
-{
-    if (QSqlDatabase::contains(DB_CONN_NAME)) {
-        return QSqlDatabase::database(DB_CONN_NAME);
-    }
-
-    QSqlDatabase db = QSqlDatabase::addDatabase("QODBC", DB_CONN_NAME);
-    db.setDatabaseName(DB_CONNECTION_STRING);
-
-    if (!db.open()) {
-        qDebug() << "DB open failed:" << db.lastError().text();
-    }
-
-    return db;
-}
+#include "db_pool.h"
+#include "fault_listing.h"
+#include "fault_rollup.h"
 // =====================================================
 // CREATE TABLE
 // =====================================================
 QJsonObject BackendGPRSFault::initTable()
 {
-    QSqlDatabase db = openDatabase();
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    QSqlDatabase db = conn.database();
 
     QSqlQuery q(db);
     q.exec("DROP TABLE IF EXISTS gprs_fault_logs");
@@ -50,12 +36,31 @@ QJsonObject BackendGPRSFault::initTable()
         ")"
         );
 
-    db.close();
-    QSqlDatabase::removeDatabase("gprs_fault_init");
+    // Indexes for the keyset listing
+    QString error;
+    if (ok && !FaultListing::createIndexes(db, "gprs_fault_logs", error))
+        return {{"success", false}, {"error", error}};
+
+    // The old rows are gone; so are their counts
+    if (ok && !FaultRollup::clear(db, FaultRollup::Gprs, error))
+        return {{"success", false}, {"error", error}};
 
     return {{"success", ok}};
 }
 
+// Listing row (columns as in FaultListing::RowFn)
+static QJsonObject faultRow(const QSqlQuery &q)
+{
+    QJsonObject row;
+    row["event_time"]   = q.value(1).toString();
+    row["loco_id"]      = q.value(2).toString();
+    row["station_code"] = q.value(3).toString();
+    row["fault_code"]   = q.value(4).toString();
+    row["description"]  = q.value(5).toString();
+    row["status"]       = q.value(6).toString();
+    return row;
+}
+
 // =====================================================
 // FETCH FAULTS
 // =====================================================
@@ -65,57 +70,27 @@ QJsonObject BackendGPRSFault::getFaults(
     int limit
     )
 {
-    QJsonArray rows;
-    QSqlDatabase db = openDatabase();
-
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
 
-    int offset = (page - 1) * limit;
-
-    QSqlQuery q(db);
-    q.prepare(
-        "SELECT event_time, loco_id, station_code, fault_code, description, status "
-        "FROM gprs_fault_logs "
-        "WHERE (:station IS NULL OR station_code = :station) "
-        "ORDER BY event_time DESC "
-        "OFFSET :offset ROWS FETCH NEXT :limit ROWS ONLY"
-        );
-
-    if (station.isEmpty())
-        q.bindValue(":station", QVariant(QVariant::String));
-    else
-        q.bindValue(":station", station);
-
-    q.bindValue(":offset", offset);
-    q.bindValue(":limit", limit);
-
-    if (!q.exec()) {
-        db.close();
-        return {{"success", false}, {"error", q.lastError().text()}};
-    }
-
-    QSqlRecord rec = q.record();
-    while (q.next()) {
-        QJsonObject row;
-        row["event_time"]   = q.value("event_time").toString();
-        row["loco_id"]      = q.value("loco_id").toString();
-        row["station_code"] = q.value("station_code").toString();
-        row["fault_code"]   = q.value("fault_code").toString();
-        row["description"]  = q.value("description").toString();
-        row["status"]       = q.value("status").toString();
-        rows.append(row);
-    }
+    return FaultListing::fetchOffsetPage(conn, "gprs_fault_logs", faultRow, station, page, limit);
+}
 
-    db.close();
-    QSqlDatabase::removeDatabase("gprs_fault_fetch");
+// =====================================================
+// FETCH FAULTS (KEYSET, FROM CURSOR)
+// =====================================================
+QJsonObject BackendGPRSFault::getFaultsFromCursor(
+    const QString &station,
+    const QString &cursor,
+    int limit
+    )
+{
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
 
-    return {
-        {"success", true},
-        {"data", rows},
-        {"page", page},
-        {"limit", limit}
-    };
+    return FaultListing::fetchPage(conn, "gprs_fault_logs", faultRow, station, cursor, limit);
 }
 
 // =====================================================
@@ -131,11 +106,9 @@ QJsonObject BackendGPRSFault::getFaultsByDateRange(
 {
 
     QJsonArray rows;
-    QSqlDatabase db = openDatabase();;
-
-    if (!db.open()) {
-        return {{"success", false}, {"error", db.lastError().text()}};
-    }
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
 
     // -------- Decode & normalize --------
     QString fromStr = fromDate;
@@ -167,8 +140,6 @@ QJsonObject BackendGPRSFault::getFaultsByDateRange(
     QDateTime toDt   = parseDate(toStr);
 
     if (!fromDt.isValid() || !toDt.isValid()) {
-        db.close();
-        QSqlDatabase::removeDatabase("gprs_fault_range");
         return {
             {"success", false},
             {"error", "Invalid date format received from frontend"}
@@ -181,46 +152,38 @@ QJsonObject BackendGPRSFault::getFaultsByDateRange(
 
     int offset = (page - 1) * limit;
 
-    QSqlQuery q(db);
-    q.prepare(
-        "SELECT event_time, loco_id, station_code, fault_code, description, status "
+    // Filtered and unfiltered are separate (cached) statements
+    QString sql =
+        "SELECT id, event_time, loco_id, station_code, fault_code, description, status "
         "FROM gprs_fault_logs "
-        "WHERE (:station IS NULL OR station_code = :station) "
-        "AND event_time >= :fromDt AND event_time <= :toDt "
-        "ORDER BY event_time DESC "
-        "OFFSET :offset ROWS FETCH NEXT :limit ROWS ONLY"
-        );
-
-    if (station.isEmpty())
-        q.bindValue(":station", QVariant(QVariant::String));
-    else
-        q.bindValue(":station", station);
-
-    q.bindValue(":fromDt", fromDt);
-    q.bindValue(":toDt", toDt);
-    q.bindValue(":offset", offset);
-    q.bindValue(":limit", limit);
-
-    if (!q.exec()) {
-        db.close();
-        QSqlDatabase::removeDatabase("gprs_fault_range");
-        return {{"success", false}, {"error", q.lastError().text()}};
+        "WHERE event_time >= ? AND event_time <= ? ";
+    if (!station.isEmpty())
+        sql += "AND station_code = ? ";
+    sql += "ORDER BY event_time DESC "
+           "OFFSET ? ROWS FETCH NEXT ? ROWS ONLY";
+
+    QSqlError error;
+    DbConnection::Statement q = conn.prepare(sql, error);
+    if (!q)
+        return {{"success", false}, {"error", error.text()}};
+
+    int n = 0;
+    q->bindValue(n++, fromDt);
+    q->bindValue(n++, toDt);
+    if (!station.isEmpty())
+        q->bindValue(n++, station);
+    q->bindValue(n++, offset);
+    q->bindValue(n++, limit);
+
+    if (!q->exec()) {
+        error = q->lastError();
+        q->finish();
+        return {{"success", false}, {"error", error.text()}};
     }
 
-    while (q.next()) {
-        QJsonObject row;
-        row["event_time"]   = q.value("event_time").toString();
-        row["loco_id"]      = q.value("loco_id").toString();
-        row["station_code"] = q.value("station_code").toString();
-        row["fault_code"]   = q.value("fault_code").toString();
-        row["description"]  = q.value("description").toString();
-        row["status"]       = q.value("status").toString();
-        rows.append(row);
-    }
-
-    db.close();
-    QSqlDatabase::removeDatabase("gprs_fault_range");
-
+    while (q->next())
+        rows.append(faultRow(*q));
+    q->finish();
 
     return {
         {"success", true},
@@ -235,8 +198,18 @@ QJsonObject BackendGPRSFault::getFaultsByDateRange(
 // =====================================================
 QJsonObject BackendGPRSFault::insertFault(const QJsonObject &p)
 {
-    QSqlDatabase db = openDatabase();;
-    if (!db.open())
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    QSqlDatabase db = conn.database();
+
+    // Row and rollup count commit together
+    QString error;
+    if (!FaultRollup::ensureTable(db, error))
+        return {{"success", false}, {"error", error}};
+
+    if (!db.transaction())
         return {{"success", false}, {"error", db.lastError().text()}};
 
     QSqlQuery q(db);
@@ -253,14 +226,27 @@ QJsonObject BackendGPRSFault::insertFault(const QJsonObject &p)
     q.addBindValue(p.value("description").toString());
     q.addBindValue(p.value("status").toString());
 
-    bool ok = q.exec();
-    if (!ok) {
-        db.close();
-        return {{"success", false}, {"error", q.lastError().text()}};
+    if (!q.exec()) {
+        QString err = q.lastError().text();
+        db.rollback();
+        return {{"success", false}, {"error", err}};
     }
 
-    db.close();
-    QSqlDatabase::removeDatabase("gprs_fault_insert");
+    FaultRollupDelta delta;
+    delta.add(p.value("station_code").toString(),
+              FaultRollup::dayOf(p.value("event_time").toString()));
+
+    QSqlError rollupError;
+    if (!FaultRollup::apply(db, FaultRollup::Gprs, delta, rollupError)) {
+        db.rollback();
+        return {{"success", false}, {"error", rollupError.text()}};
+    }
+
+    if (!db.commit()) {
+        QString err = db.lastError().text();
+        db.rollback();
+        return {{"success", false}, {"error", err}};
+    }
 
     return {{"success", true}};
 }
@@ -270,9 +256,11 @@ QJsonObject BackendGPRSFault::insertFault(const QJsonObject &p)
 // =====================================================
 QJsonObject BackendGPRSFault::getStations()
 {
-    QSqlDatabase db = openDatabase();;
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    QSqlDatabase db = conn.database();
 
     QSqlQuery q(db);
     QJsonArray stations;
@@ -283,7 +271,6 @@ QJsonObject BackendGPRSFault::getStations()
             "WHERE station_code IS NOT NULL "
             "ORDER BY station_code"
             )) {
-        db.close();
         return {{"success", false}, {"error", q.lastError().text()}};
     }
 
@@ -291,8 +278,6 @@ QJsonObject BackendGPRSFault::getStations()
         stations.append(q.value(0).toString());
     }
 
-    db.close();
-    QSqlDatabase::removeDatabase("gprs_stations");
 
     return {
         {"success", true},
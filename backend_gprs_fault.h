@@ -12,6 +12,13 @@ public:
         int page,
         int limit
         );
+    // Newest first, continuing after 'cursor' (the nextCursor of the
+    // previous page; empty: first page)
+    static QJsonObject getFaultsFromCursor(
+        const QString &station,
+        const QString &cursor,
+        int limit
+        );
     static QJsonObject getFaultsByDateRange(
         const QString &station,
         const QString &fromDate,
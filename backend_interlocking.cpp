@@ -1,43 +1,26 @@
 #include "backend_interlocking.h"
 
-#include <QFile>
 #include <QDir>
 #include <QFileInfo>
-#include <QTextStream>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QDateTime>
 #include <QUrl>
+#include <QStringList>
+#include <QHash>
 #include <QSet>
+#include <QTime>
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
 
 #include "stations_config.h"
 #include "interlocking_relays_config.h"
-
-// ---------------------------------------------
-// Hex bitmap → binary string (desktop parity)
-// ---------------------------------------------
-static QString hexToBinary(const QString &hex)
-{
-    QString bin;
-    for (int i = 0; i < hex.length(); i += 2) {
-        QByteArray b = QByteArray::fromHex(hex.mid(i,2).toLatin1());
-        for (unsigned char c : b)
-            bin += QString::number(c, 2).rightJustified(8, '0');
-    }
-    return bin;
-}
-
-// ---------------------------------------------
-// Reverse byte order (LSB swap)
-// ---------------------------------------------
-static QString reverseBytes(const QString &hex)
-{
-    QString out;
-    for (int i = 0; i < hex.length(); i += 2)
-        out = hex.mid(i,2) + out;
-    return out;
-}
-
+#include "log_parallel.h"
+#include "log_scanner.h"
+#include "relay_state_store.h"
+#include "crc32.h"
 
     // =====================================================
     // Helpers
@@ -61,26 +44,42 @@ static QString reverseBytes(const QString &hex)
     return {};
 }
 
-static QStringList readBinLines(const QString &filePath)
+// packetTime() seconds -> wall clock date / time of day
+static QDate packetDate(quint32 t)
+{
+    static const QDate epoch(2000, 1, 1);
+    return epoch.addDays(t / 86400);
+}
+
+static int secondOfDay(quint32 t)
 {
-    QFile f(filePath);
-    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
-        return {};
-
-    QTextStream in(&f);
-    QString raw = in.readAll().toUpper().trimmed();
-
-    raw.replace("AAAA15", "\nAAAA15");
-    raw.replace("AAAA16", "\nAAAA16");
-
-    QStringList packets;
-    for (const QString &line : raw.split("\n", Qt::SkipEmptyParts)) {
-        QString spaced;
-        for (int i = 0; i < line.length(); i += 2)
-            spaced += line.mid(i, 2) + " ";
-        packets.append(spaced.trimmed());
+    return int(t % 86400);
+}
+
+// Bits [64*w, 64*w + 64) of a XOR b, limited to bits < count. QBitArray
+// keeps bit i in byte i/8, LSB first; both arrays hold >= count bits.
+static quint64 flipWord(const QBitArray &a, const QBitArray &b,
+                        qsizetype count, qsizetype w)
+{
+    const uchar *pa = reinterpret_cast<const uchar *>(a.bits()) + w * 8;
+    const uchar *pb = reinterpret_cast<const uchar *>(b.bits()) + w * 8;
+    const qsizetype bits = qMin<qsizetype>(64, count - w * 64);
+
+    quint64 x = 0;
+    if (bits == 64) {
+        x = qFromLittleEndian<quint64>(pa) ^ qFromLittleEndian<quint64>(pb);
+    } else {
+        for (int k = 0; k < (bits + 7) / 8; ++k)
+            x |= quint64(pa[k] ^ pb[k]) << (8 * k);
+        x &= (quint64(1) << bits) - 1;
     }
-    return packets;
+    return x;
+}
+
+static QString relayStatus(const RelayInfo &relay, bool bit)
+{
+    // _TPR relays are picked up when the bit is clear
+    return (bit != relay.relay_name.endsWith("_TPR")) ? "Picked Up" : "Drop Down";
 }
 
 static QDate parseFileDate(const QString &fileName)
@@ -106,36 +105,34 @@ QJsonObject BackendInterlocking::getStationsForDateRange(
     if (!fromDt.isValid() || !toDt.isValid())
         return {{"success", false}, {"error", "Invalid from/to date format"}};
 
+    const quint32 fromTime = LogContainer::wallTime(fromDt);
+    const quint32 toTime   = LogContainer::wallTime(toDt);
+
     QSet<QString> stations;
 
+    QStringList paths;
     for (const QString &file : QDir(folder).entryList({"*.bin"}, QDir::Files)) {
         QDate fileDate = parseFileDate(file);
         if (!fileDate.isValid() || fileDate < fromDt.date() || fileDate > toDt.date())
             continue;
 
-        for (const QString &pkt : readBinLines(folder + "/" + file)) {
-            if (!pkt.startsWith("AA AA 15")) continue;
-
-            QStringList f = pkt.split(" ");
-            if (f.size() < 18) continue;
+        paths.append(folder + "/" + file);
+    }
 
-            QDateTime pktDt(
-                QDate(2000 + f[14].toInt(nullptr,16),
-                      f[13].toInt(nullptr,16),
-                      f[12].toInt(nullptr,16)),
-                QTime(f[15].toInt(nullptr,16),
-                      f[16].toInt(nullptr,16),
-                      f[17].toInt(nullptr,16))
-                );
+    // Days missing from the relay store are built concurrently
+    const auto days =
+        LogParallel::mapDays<QSharedPointer<const RelayDayState>>(paths, RelayStateStore::day);
 
-            if (pktDt < fromDt || pktDt > toDt) continue;
+    for (const auto &day : days) {
+        if (!day)
+            continue;
 
-            bool ok;
-            int stnId = (f[7] + f[8]).toInt(&ok,16);
-            if (!ok) continue;
+        for (auto it = day->stations.cbegin(); it != day->stations.cend(); ++it) {
+            if (!it.value().hasSnapshotIn(fromTime, toTime))
+                continue;
 
             StationInfo s;
-            if (getStationById(stnId, s))
+            if (getStationById(it.key(), s))
                 stations.insert(s.station_code);
         }
     }
@@ -145,9 +142,273 @@ QJsonObject BackendInterlocking::getStationsForDateRange(
     return {{"success", true}, {"data", out}};
 }
 
+// =====================================================
+// REPORT CURSOR
+// =====================================================
+
+// Position of the next row: day file, station id, entry of the relay
+// store and relay (AAAA15) or event (AAAA16) within it. 'row' is the
+// number of rows before it; 'total' is counted on the first page only.
+struct ReportCursor
+{
+    QString file;
+    int station = 0;
+    qint32 entry = 0;
+    qint32 sub = 0;
+    qint64 row = 0;
+    qint64 total = -1;
+    quint32 query = 0;   // CRC of the query the cursor belongs to
+};
+
+static quint32 queryKey(const QString &folder, const QString &fromDate,
+                        const QString &toDate, const QString &stationCode)
+{
+    const QByteArray key =
+        QStringList{folder, fromDate, toDate, stationCode}.join('\n').toUtf8();
+    return Crc32::reflected(reinterpret_cast<const quint8 *>(key.constData()),
+                            key.size());
+}
+
+static QString encodeCursor(const ReportCursor &c)
+{
+    const QString text = QStringList{
+        c.file, QString::number(c.station), QString::number(c.entry),
+        QString::number(c.sub), QString::number(c.row),
+        QString::number(c.total), QString::number(c.query)
+    }.join('|');
+
+    return QString::fromLatin1(text.toUtf8().toBase64(
+        QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+}
+
+static bool decodeCursor(const QString &text, ReportCursor &c)
+{
+    const auto decoded = QByteArray::fromBase64Encoding(
+        text.toLatin1(),
+        QByteArray::Base64UrlEncoding | QByteArray::AbortOnBase64DecodingErrors);
+    if (!decoded)
+        return false;
+
+    const QStringList p = QString::fromUtf8(*decoded).split('|');
+    if (p.size() != 7)
+        return false;
+
+    bool ok[6];
+    c.file    = p[0];
+    c.station = p[1].toInt(&ok[0]);
+    c.entry   = p[2].toInt(&ok[1]);
+    c.sub     = p[3].toInt(&ok[2]);
+    c.row     = p[4].toLongLong(&ok[3]);
+    c.total   = p[5].toLongLong(&ok[4]);
+    c.query   = p[6].toUInt(&ok[5]);
+
+    for (bool b : ok)
+        if (!b)
+            return false;
+
+    return c.entry >= 0 && c.sub >= 0 && c.row >= 0;
+}
+
 // =====================================================
 // GENERATE REPORT (AAAA15 + AAAA16)
 // =====================================================
+
+// Rows [firstRow, firstRow + PAGE_SIZE) of the report. From a cursor the
+// walk starts at its position (row firstRow) and stops once the page is
+// full; otherwise it starts at the beginning and counts every row.
+// With a sink every row of the range goes to it instead, and the walk
+// stops early only if the sink does.
+static QJsonObject buildReport(
+    const QString &folder,
+    const QDateTime &fromDt,
+    const QDateTime &toDt,
+    const QString &stationCode,
+    qint64 firstRow,
+    const ReportCursor *resume,
+    const RowSink *sink,
+    ReportCursor &next,
+    bool &hasNext,
+    qint64 &totalRows)
+{
+    const auto relays = getInterlockingRelaysForStation(stationCode);
+    const int PAGE_SIZE = 5000;
+
+    const quint32 fromTime = LogContainer::wallTime(fromDt);
+    const quint32 toTime   = LogContainer::wallTime(toDt);
+
+    QHash<int, int> relayIndex;   // address -> position in 'relays'
+    for (int i = relays.size() - 1; i >= 0; --i)
+        relayIndex.insert(relays[i].address, i);
+
+    // Streaming: the whole range is one page (halved so that the page
+    // arithmetic below cannot overflow)
+    const qint64 lastRow = sink ? std::numeric_limits<qint64>::max() / 2
+                                : firstRow + PAGE_SIZE;
+    const bool stopEarly = resume && resume->total >= 0;
+    bool open = true;   // false once the sink's client is gone
+
+    QJsonArray rows;
+    totalRows = resume ? resume->row : 0;
+    hasNext = false;
+
+    auto appendRow = [&](quint32 t, const RelayInfo &relay, bool pickedUp) {
+        QJsonObject r;
+        r["date"]    = packetDate(t).toString("yyyy-MM-dd");
+        r["time"]    = QTime(0, 0).addSecs(secondOfDay(t)).toString("HH:mm:ss");
+        r["frameNo"] = QString::number(secondOfDay(t) + 1);
+        r["station"] = stationCode;
+        r["relay"]   = relay.relay_name;
+        r["serial"]  = relay.serial;
+        r["status"]  = pickedUp ? "Picked Up" : "Drop Down";
+        if (sink)
+            open = open && (*sink)(r);
+        else
+            rows.append(r);
+    };
+
+    QStringList files;
+    for (const QString &file : QDir(folder).entryList({"*.bin"}, QDir::Files)) {
+        QDate fileDate = parseFileDate(file);
+        if (fileDate.isValid() && fileDate >= fromDt.date() && fileDate <= toDt.date())
+            files.append(file);
+    }
+
+    int firstFile = 0;
+    if (resume) {
+        firstFile = files.indexOf(resume->file);
+        if (firstFile < 0)
+            return {{"success", false}, {"error", "Invalid cursor"}};
+    }
+
+    // A full walk builds the missing days concurrently up front; a
+    // resumed page loads them one by one as it goes and stops early, and
+    // so does a stream, which keeps no more than one day in flight
+    const bool lazy = stopEarly || sink;
+
+    QVector<QSharedPointer<const RelayDayState>> loaded;
+    if (!lazy) {
+        QStringList paths;
+        for (int f = firstFile; f < files.size(); ++f)
+            paths.append(folder + "/" + files[f]);
+
+        loaded = LogParallel::mapDays<QSharedPointer<const RelayDayState>>(
+            paths, RelayStateStore::day);
+    }
+
+    for (int f = firstFile; f < files.size() && open && !(hasNext && stopEarly); ++f) {
+
+        auto day = lazy ? RelayStateStore::day(folder + "/" + files[f])
+                        : loaded.at(f - firstFile);
+        if (!day)
+            continue;
+
+        // Station ids of this code, in a fixed order
+        QList<int> ids;
+        for (auto st = day->stations.cbegin(); st != day->stations.cend(); ++st) {
+            StationInfo s;
+            if (getStationById(st.key(), s) && s.station_code == stationCode)
+                ids.append(st.key());
+        }
+        std::sort(ids.begin(), ids.end());
+
+        for (int id : ids) {
+            if ((hasNext && stopEarly) || !open)
+                break;
+
+            const bool resumeHere = resume && f == firstFile;
+            if (resumeHere && id < resume->station)
+                continue;
+
+            const bool atCursor = resumeHere && id == resume->station;
+            const qint32 startEntry = atCursor ? resume->entry : 0;
+
+            const RelayStationLog &log = *day->stations.constFind(id);
+
+            for (qint32 k = startEntry; k < log.entries.size(); ++k) {
+                const RelayEntry &e = log.entries.at(k);
+                if (e.time < fromTime || e.time > toTime)
+                    continue;
+
+                const qint32 sub = (atCursor && k == startEntry) ? resume->sub : 0;
+
+                // ================= AAAA15 =================
+                // One row per configured relay; only rows on this page
+                // are built. Relay i is row totalRows + (i - sub).
+                if (e.snapshot >= 0) {
+                    const QBitArray &bits = log.snapshots.at(e.snapshot);
+                    const qint64 n = qMin<qint64>(relays.size(), bits.size());
+
+                    const qint64 from = qMax<qint64>(sub, sub + firstRow - totalRows);
+                    const qint64 to   = qMin<qint64>(n, sub + lastRow - totalRows);
+
+                    for (qint64 i = from; i < to; ++i) {
+                        // _TPR relays are picked up when the bit is clear
+                        const bool isTPR = relays[i].relay_name.endsWith("_TPR");
+                        appendRow(e.time, relays[i], bits.testBit(i) != isTPR);
+                    }
+
+                    const qint64 cut = sub + lastRow - totalRows;
+                    if (!hasNext && cut >= sub && cut < n) {
+                        next.file = files[f];
+                        next.station = id;
+                        next.entry = k;
+                        next.sub = qint32(cut);
+                        hasNext = true;
+                    }
+
+                    totalRows += qMax<qint64>(0, n - sub);
+                }
+                // ================= AAAA16 =================
+                else {
+                    for (int i = sub; i < e.deltaCount; ++i) {
+                        const RelayDelta &d = log.deltas.at(e.firstDelta + i);
+
+                        const int index = relayIndex.value(d.address, -1);
+                        if (index < 0)
+                            continue;
+
+                        if (!hasNext && totalRows == lastRow) {
+                            next.file = files[f];
+                            next.station = id;
+                            next.entry = k;
+                            next.sub = i;
+                            hasNext = true;
+                        }
+
+                        totalRows++;
+                        if (totalRows <= firstRow || totalRows > lastRow)
+                            continue;
+
+                        const bool isTPR = relays[index].relay_name.endsWith("_TPR");
+                        appendRow(e.time, relays[index], d.set != isTPR);
+                    }
+                }
+
+                if ((hasNext && stopEarly) || !open)
+                    break;
+            }
+        }
+    }
+
+    if (sink)
+        return {{"success", true}, {"totalRows", totalRows}};
+
+    if (stopEarly)
+        totalRows = resume->total;
+
+    next.row = lastRow;
+    next.total = totalRows;
+
+    int totalPages = int(qMax<qint64>(1, (totalRows + PAGE_SIZE - 1) / PAGE_SIZE));
+    return {
+        {"success", true},
+        {"data", rows},
+        {"totalRows", totalRows},
+        {"totalPages", totalPages},
+        {"page", int(firstRow / PAGE_SIZE) + 1}
+    };
+}
+
 QJsonObject BackendInterlocking::generateReportByDateRange(
     const QString &logDir,
     const QString &fromDate,
@@ -162,164 +423,234 @@ QJsonObject BackendInterlocking::generateReportByDateRange(
     if (!fromDt.isValid() || !toDt.isValid())
         return {{"success", false}, {"error", "Invalid from/to date format"}};
 
-    const auto relays = getInterlockingRelaysForStation(stationCode);
     const int PAGE_SIZE = 5000;
 
-    QJsonArray rows;
-    int totalRows = 0;
+    ReportCursor next;
+    bool hasNext;
+    qint64 totalRows;
 
-    for (const QString &file : QDir(folder).entryList({"*.bin"}, QDir::Files)) {
+    QJsonObject res = buildReport(folder, fromDt, toDt, stationCode,
+                                  qint64(page - 1) * PAGE_SIZE, nullptr, nullptr,
+                                  next, hasNext, totalRows);
 
-        QDate fileDate = parseFileDate(file);
-        if (!fileDate.isValid() || fileDate < fromDt.date() || fileDate > toDt.date())
-            continue;
+    next.query = queryKey(folder, fromDate, toDate, stationCode);
+    if (res.value("success").toBool())
+        res["nextCursor"] = hasNext ? encodeCursor(next) : QString();
+    return res;
+}
 
-        for (const QString &pkt : readBinLines(folder + "/" + file)) {
+QJsonObject BackendInterlocking::generateReportFromCursor(
+    const QString &logDir,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &stationCode,
+    const QString &cursor)
+{
+    QString folder = QUrl::fromPercentEncoding(logDir.toUtf8());
+    QDateTime fromDt = parseDateTime(fromDate);
+    QDateTime toDt   = parseDateTime(toDate);
 
-            QStringList f = pkt.split(" ");
-            if (f.size() < 20) continue;
+    if (!fromDt.isValid() || !toDt.isValid())
+        return {{"success", false}, {"error", "Invalid from/to date format"}};
 
-            // ================= AAAA15 =================
-            if (f[0]=="AA" && f[1]=="AA" && f[2]=="15") {
+    // No cursor: first page
+    if (cursor.isEmpty())
+        return generateReportByDateRange(logDir, fromDate, toDate, stationCode, 1);
 
-                bool ok;
-                int stnId = (f[7] + f[8]).toInt(&ok,16);
-                StationInfo s;
-                if (!ok || !getStationById(stnId,s) || s.station_code!=stationCode)
-                    continue;
+    const quint32 query = queryKey(folder, fromDate, toDate, stationCode);
 
-                QDateTime pktDt(
-                    QDate(2000+f[14].toInt(nullptr,16),
-                          f[13].toInt(nullptr,16),
-                          f[12].toInt(nullptr,16)),
-                    QTime(f[15].toInt(nullptr,16),
-                          f[16].toInt(nullptr,16),
-                          f[17].toInt(nullptr,16))
-                    );
-                if (pktDt < fromDt || pktDt > toDt) continue;
-
-                int frame =
-                    pktDt.time().hour()*3600 +
-                    pktDt.time().minute()*60 +
-                    pktDt.time().second() + 1;
-
-                // Extract relay bitmap hex
-                QString bitmapHex;
-                for (int i = 21; i < f.size(); ++i)
-                    bitmapHex += f[i];
-
-                // Desktop: byte swap → binary
-                QString swapped = reverseBytes(bitmapHex);
-                QString binData = hexToBinary(swapped);
-
-                for (int i = 0; i < relays.size() && i < binData.length(); ++i) {
-                    totalRows++;
-                    if (totalRows <= (page-1)*PAGE_SIZE || totalRows > page*PAGE_SIZE)
-                        continue;
+    ReportCursor resume;
+    if (!decodeCursor(cursor, resume) || resume.query != query)
+        return {{"success", false}, {"error", "Invalid cursor"}};
 
-                    bool isTPR = relays[i].relay_name.endsWith("_TPR");
-                    QChar bit = binData[i];
-
-                    QString status;
-                    if (isTPR)
-                        status = (bit == '0') ? "Picked Up" : "Drop Down";
-                    else
-                        status = (bit == '1') ? "Picked Up" : "Drop Down";
-
-                    QJsonObject r;
-                    r["date"]    = pktDt.date().toString("yyyy-MM-dd");
-                    r["time"]    = pktDt.time().toString("HH:mm:ss");
-                    r["frameNo"] = QString::number(frame);
-                    r["station"] = stationCode;
-                    r["relay"]   = relays[i].relay_name;
-                    r["serial"]  = relays[i].serial;
-                    r["status"]  = status;
-
-                    rows.append(r);
-                }
+    ReportCursor next;
+    bool hasNext;
+    qint64 totalRows;
 
-            }
+    QJsonObject res = buildReport(folder, fromDt, toDt, stationCode,
+                                  resume.row, &resume, nullptr,
+                                  next, hasNext, totalRows);
 
-            // ================= AAAA16 =================
-            else if (f[0]=="AA" && f[1]=="AA" && f[2]=="16") {
+    next.query = query;
+    if (res.value("success").toBool())
+        res["nextCursor"] = hasNext ? encodeCursor(next) : QString();
+    return res;
+}
 
-                bool ok;
-                int stnId = (f[7] + f[8]).toInt(&ok,16);
-                StationInfo s;
-                if (!ok || !getStationById(stnId,s) || s.station_code!=stationCode)
-                    continue;
+QJsonObject BackendInterlocking::streamReportByDateRange(
+    const QString &logDir,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &stationCode,
+    const RowSink &sink)
+{
+    QString folder = QUrl::fromPercentEncoding(logDir.toUtf8());
+    QDateTime fromDt = parseDateTime(fromDate);
+    QDateTime toDt   = parseDateTime(toDate);
 
-                QDateTime pktDt(
-                    QDate(2000+f[14].toInt(nullptr,16),
-                          f[13].toInt(nullptr,16),
-                          f[12].toInt(nullptr,16)),
-                    QTime(f[15].toInt(nullptr,16),
-                          f[16].toInt(nullptr,16),
-                          f[17].toInt(nullptr,16))
-                    );
-                if (pktDt < fromDt || pktDt > toDt) continue;
-
-                int frame =
-                    pktDt.time().hour()*3600 +
-                    pktDt.time().minute()*60 +
-                    pktDt.time().second() + 1;
-
-                int eventCount = f[18].toInt(nullptr,16);
-
-                for (int i = 0; i < eventCount && (21 + 3*i + 1) < f.size(); ++i) {
-
-                    // Relay address (2 bytes)
-                    QString relayAddrHex = f[19 + 3*i] + f[20 + 3*i];
-                    QString statusHex    = f[21 + 3*i];
-
-                    bool ok;
-                    int relayAddr = relayAddrHex.toInt(&ok, 16);
-                    if (!ok) continue;
-
-                    auto it = std::find_if(
-                        relays.begin(),
-                        relays.end(),
-                        [&](const RelayInfo &r) {
-                            return r.address == relayAddr;
-                        }
-                        );
+    if (!fromDt.isValid() || !toDt.isValid())
+        return {{"success", false}, {"error", "Invalid from/to date format"}};
 
+    ReportCursor next;
+    bool hasNext;
+    qint64 totalRows;
 
-                    if (it == relays.end())
-                        continue;
+    return buildReport(folder, fromDt, toDt, stationCode, 0, nullptr, &sink,
+                       next, hasNext, totalRows);
+}
 
-                    totalRows++;
-                    if (totalRows <= (page-1)*PAGE_SIZE || totalRows > page*PAGE_SIZE)
-                        continue;
+// =====================================================
+// 3️⃣ TRANSITIONS ONLY (AAAA15 diffs + AAAA16)
+// =====================================================
+QJsonObject BackendInterlocking::generateTransitionsByDateRange(
+    const QString &logDir,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &stationCode,
+    int page)
+{
+    QString folder = QUrl::fromPercentEncoding(logDir.toUtf8());
+    QDateTime fromDt = parseDateTime(fromDate);
+    QDateTime toDt   = parseDateTime(toDate);
+
+    if (!fromDt.isValid() || !toDt.isValid())
+        return {{"success", false}, {"error", "Invalid from/to date format"}};
+
+    const auto relays = getInterlockingRelaysForStation(stationCode);
+    const int PAGE_SIZE = 5000;
+
+    const quint32 fromTime = LogContainer::wallTime(fromDt);
+    const quint32 toTime   = LogContainer::wallTime(toDt);
+
+    QHash<int, int> relayIndex;   // address -> position in 'relays'
+    for (int i = relays.size() - 1; i >= 0; --i)
+        relayIndex.insert(relays[i].address, i);
+
+    const qint64 firstRow = qint64(page - 1) * PAGE_SIZE;
+    const qint64 lastRow  = qint64(page) * PAGE_SIZE;
 
-                    QJsonObject r;
-                    r["date"]    = pktDt.date().toString("yyyy-MM-dd");
-                    r["time"]    = pktDt.time().toString("HH:mm:ss");
-                    r["frameNo"] = QString::number(frame);
-                    r["station"] = stationCode;
-                    r["relay"]   = it->relay_name;
-                    r["serial"]  = it->serial;
-                    bool isTPR = it->relay_name.endsWith("_TPR");
+    QJsonArray rows;
+    qint64 totalRows = 0;
+
+    auto appendRow = [&](quint32 t, const RelayInfo &relay,
+                         const QString &previous, const QString &status) {
+        QJsonObject r;
+        r["date"]     = packetDate(t).toString("yyyy-MM-dd");
+        r["time"]     = QTime(0, 0).addSecs(secondOfDay(t)).toString("HH:mm:ss");
+        r["frameNo"]  = QString::number(secondOfDay(t) + 1);
+        r["station"]  = stationCode;
+        r["relay"]    = relay.relay_name;
+        r["serial"]   = relay.serial;
+        r["previous"] = previous;
+        r["status"]   = status;
+        rows.append(r);
+    };
+
+    // Relay state per station id, carried from day to day. Empty until
+    // the first full bitmap, which is the baseline and emits nothing;
+    // events before it have no previous state.
+    QHash<int, QBitArray> state;
 
-                    QString status;
-                    if (isTPR)
-                        status = (statusHex == "01") ? "Drop Down" : "Picked Up";
-                    else
-                        status = (statusHex == "01") ? "Picked Up" : "Drop Down";
+    // Days are built concurrently, then diffed in date order so every
+    // diff is against the state just before it
+    const auto days = LogParallel::mapDays<QSharedPointer<const RelayDayState>>(
+        LogParallel::dayPaths(folder, fromDt.date(), toDt.date()),
+        RelayStateStore::day);
 
-                    r["status"] = status;
+    for (const auto &day : days) {
+        if (!day)
+            continue;
 
+        // Station ids of this code, in a fixed order (QHash order is
+        // seeded per process)
+        QList<int> ids;
+        for (auto st = day->stations.cbegin(); st != day->stations.cend(); ++st) {
+            StationInfo s;
+            if (getStationById(st.key(), s) && s.station_code == stationCode)
+                ids.append(st.key());
+        }
+        std::sort(ids.begin(), ids.end());
+
+        for (int id : ids) {
+
+            const RelayStationLog &log = *day->stations.constFind(id);
+            QBitArray &current = state[id];
+
+            if (current.isEmpty() && fromTime > 0)
+                current = log.stateAt(fromTime - 1, relayIndex);
+
+            for (const RelayEntry &e : log.entries) {
+                if (e.time < fromTime || e.time > toTime)
+                    continue;
 
-                    rows.append(r);
+                // ================= AAAA15 =================
+                // Word-wide XOR against the current state; popcount
+                // counts whole words that fall outside this page
+                if (e.snapshot >= 0) {
+                    const QBitArray &bits = log.snapshots.at(e.snapshot);
+
+                    const qsizetype count =
+                        qMin<qsizetype>(relays.size(), qMin(bits.size(), current.size()));
+
+                    // Unchanged bitmaps share storage with the previous one
+                    if (bits.bits() != current.bits()) {
+                        for (qsizetype w = 0; w * 64 < count; ++w) {
+                            quint64 x = flipWord(current, bits, count, w);
+
+                            const int flips = qPopulationCount(x);
+                            if (totalRows + flips <= firstRow || totalRows >= lastRow) {
+                                totalRows += flips;
+                                continue;
+                            }
+
+                            for (; x; x &= x - 1) {
+                                const qsizetype i = w * 64 + qCountTrailingZeroBits(x);
+
+                                totalRows++;
+                                if (totalRows <= firstRow || totalRows > lastRow)
+                                    continue;
+
+                                appendRow(e.time, relays[i],
+                                          relayStatus(relays[i], current.testBit(i)),
+                                          relayStatus(relays[i], bits.testBit(i)));
+                            }
+                        }
+                    }
+
+                    current = bits;
+                    continue;
                 }
 
+                // ================= AAAA16 =================
+                for (int i = 0; i < e.deltaCount; ++i) {
+                    const RelayDelta &delta = log.deltas.at(e.firstDelta + i);
+
+                    const int index = relayIndex.value(delta.address, -1);
+                    if (index < 0)
+                        continue;
+
+                    const bool known = index < current.size();
+                    if (known && current.testBit(index) == delta.set)
+                        continue;
+
+                    totalRows++;
+                    if (totalRows > firstRow && totalRows <= lastRow)
+                        appendRow(e.time, relays[index],
+                                  known ? relayStatus(relays[index], current.testBit(index))
+                                        : QString("Unknown"),
+                                  relayStatus(relays[index], delta.set));
+
+                    if (known)
+                        current.setBit(index, delta.set);
+                }
             }
         }
     }
 
-    int totalPages = qMax(1, (totalRows + PAGE_SIZE - 1) / PAGE_SIZE);
+    int totalPages = int(qMax<qint64>(1, (totalRows + PAGE_SIZE - 1) / PAGE_SIZE));
     return {
         {"success", true},
+        {"mode", "transitions"},
         {"data", rows},
         {"totalRows", totalRows},
         {"totalPages", totalPages},
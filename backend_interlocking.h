@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QJsonObject>
 
+#include "row_sink.h"
+
 class BackendInterlocking : public QObject
 {
     Q_OBJECT
@@ -31,6 +33,38 @@ public:
         const QString &stationCode,
         int page
         );
+
+    // Same report, resumed from the 'nextCursor' of the previous page
+    // (empty: first page). Each call reads only its own page; totalRows
+    // is counted once, on the first page, and carried in the cursor.
+    QJsonObject generateReportFromCursor(
+        const QString &logDir,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &stationCode,
+        const QString &cursor
+        );
+
+    // Whole report, each row handed to 'sink' as it is built (NDJSON
+    // streaming); returns the status and totalRows without "data"
+    QJsonObject streamReportByDateRange(
+        const QString &logDir,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &stationCode,
+        const RowSink &sink
+        );
+
+    // =====================================================
+    // 3️⃣ Relay transitions only (FROM–TO)
+    // =====================================================
+    QJsonObject generateTransitionsByDateRange(
+        const QString &logDir,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &stationCode,
+        int page
+        );
 };
 
 #endif // BACKEND_INTERLOCKING_H
@@ -1,9 +1,10 @@
 #include "backend_loco_fault.h"
+#include "lvk_fault_parser.h"
+#include "log_parallel.h"
+#include "log_scanner.h"
 
-#include <QFile>
 #include <QDir>
 #include <QFileInfo>
-#include <QTextStream>
 #include <QUrl>
 #include <QDateTime>
 #include <QJsonArray>
@@ -26,25 +27,6 @@ QDate BackendLocoFault::parseFileDate(const QString& filePath)
                  p[1].toInt(),
                  p[0].toInt());
 }
-static quint32 calculateCRC32(const QByteArray &data)
-{
-    quint32 crc = 0xFFFFFFFF;
-
-    for (unsigned char byte : data)
-    {
-        crc ^= byte;
-
-        for (int i = 0; i < 8; ++i)
-        {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xEDB88320;
-            else
-                crc >>= 1;
-        }
-    }
-
-    return crc ^ 0xFFFFFFFF;
-}
 
 // =====================================================
 // MAIN API
@@ -52,7 +34,9 @@ static quint32 calculateCRC32(const QByteArray &data)
 QJsonObject BackendLocoFault::fetchByDateRange(
     const QString& fromDate,
     const QString& toDate,
-    const QString& logDir)
+    const QString& logDir,
+    bool validateCrc,
+    const RowSink& sink)
 {
     QJsonArray rows;
 
@@ -73,206 +57,230 @@ QJsonObject BackendLocoFault::fetchByDateRange(
         QDir(folder).entryList({"*.bin"}, QDir::Files, QDir::Name);
 
     // =====================================================
-    // FILE LOOP
+    // PACKET HANDLER (AAAA19 station / BBBB19 loco)
     // =====================================================
-    for (const QString& file : files)
+    auto onFault = [validateCrc](const LogPacket& pkt, const RowSink& out)
     {
-        QString fullPath = folder + "/" + file;
-
-        QDate fileDate = parseFileDate(fullPath);
-        if (!fileDate.isValid())
-            continue;
+        const bool isStation = (pkt.sof == LogScanner::SOF_AAAA);
+        const QByteArrayView raw(reinterpret_cast<const char*>(pkt.data), pkt.length);
 
-        if (fileDate < fromDt.date() || fileDate > toDt.date())
-            continue;
+        if (raw.size() < 29)
+            return;
 
-        QFile f(fullPath);
-        if (!f.open(QIODevice::ReadOnly))
-            continue;
+        const quint8* d =
+            reinterpret_cast<const quint8*>(raw.constData());
 
-        QTextStream in(&f);
+        int idx = 0;
 
-        // =====================================================
-        // LINE LOOP
-        // =====================================================
-        while (!in.atEnd())
-        {
-            QString line = in.readLine().trimmed();
+        // ---------------- SOF ----------------
+        quint16 sof = (d[idx] << 8) | d[idx + 1];
+        idx += 2;
 
-            line = line.toUpper();
+        // ---------------- MSG TYPE ----------------
+        quint8 msgType = d[idx++];
+        if (msgType != 0x19)
+            return;
 
-            if (!line.contains("AAAA19") &&
-                !line.contains("BBBB19"))
-                continue;
+        // ---------------- MSG LENGTH ----------------
+        quint16 msgLength =
+            (d[idx] << 8) | d[idx + 1];
+        idx += 2;
+        if (msgLength != raw.size() - 2)
+            return;
 
 
-            bool isStation = line.startsWith("AAAA19");
+        // ---------------- SEQ ----------------
+        quint16 msgSeq =
+            (d[idx] << 8) | d[idx + 1];
+        idx += 2;
 
-            QByteArray raw = QByteArray::fromHex(line.toLatin1());
+        // ---------------- KAVACH SUBSYSTEM ID (3 bytes) ----------------
+        quint32 kavachId =
+            (d[idx] << 16) |
+            (d[idx + 1] << 8) |
+            d[idx + 2];
+        idx += 3;
 
-            if (raw.size() < 29)
-                continue;
+        // ---------------- NMS SYSTEM ID ----------------
+        quint16 nmsId =
+            (d[idx] << 8) | d[idx + 1];
+        idx += 2;
 
-            const quint8* d =
-                reinterpret_cast<const quint8*>(raw.constData());
+        // ---------------- VERSION ----------------
+        quint8 version = d[idx++];
 
-            int idx = 0;
+        // ---------------- DATE ----------------
+        quint8 day   = d[idx++];
+        quint8 month = d[idx++];
+        quint8 year  = d[idx++];
 
-            // ---------------- SOF ----------------
-            quint16 sof = (d[idx] << 8) | d[idx + 1];
-            idx += 2;
 
-            // ---------------- MSG TYPE ----------------
-            quint8 msgType = d[idx++];
-            if (msgType != 0x19)
-                continue;
+        // ---------------- TIME ----------------
+        quint8 hh = d[idx++];
+        quint8 mm = d[idx++];
+        quint8 ss = d[idx++];
 
-            // ---------------- MSG LENGTH ----------------
-            quint16 msgLength =
-                (d[idx] << 8) | d[idx + 1];
-            idx += 2;
-            if (msgLength != raw.size() - 2)
-                continue;
+        QDateTime pktTime(
+            QDate(2000 + year, month, day),
+            QTime(hh, mm, ss)
+            );
 
+        // if (!pktTime.isValid())
+        //     continue;
 
-            // ---------------- SEQ ----------------
-            quint16 msgSeq =
-                (d[idx] << 8) | d[idx + 1];
-            idx += 2;
+        // OPTIONAL time filter (uncomment if needed)
+        /*
+        if (pktTime < fromDt || pktTime > toDt)
+            return;
+        */
 
-            // ---------------- KAVACH SUBSYSTEM ID (3 bytes) ----------------
-            quint32 kavachId =
-                (d[idx] << 16) |
-                (d[idx + 1] << 8) |
-                d[idx + 2];
-            idx += 3;
-
-            // ---------------- NMS SYSTEM ID ----------------
-            quint16 nmsId =
-                (d[idx] << 8) | d[idx + 1];
-            idx += 2;
+        // ---------------- SUBSYSTEM TYPE ----------------
+        quint8 subsystemType = d[idx++];
 
-            // ---------------- VERSION ----------------
-            quint8 version = d[idx++];
+        // ---------------- FAULT COUNT ----------------
+        quint8 totalFault = d[idx++];
+        if (totalFault > 10)
+            return;
+        // ---- CRC VALIDATION (shared with LVKFaultParser) ----
+        if (validateCrc && !LVKFaultParser::crcOk(d, int(raw.size())))
+            return;
 
-            // ---------------- DATE ----------------
-            quint8 day   = d[idx++];
-            quint8 month = d[idx++];
-            quint8 year  = d[idx++];
 
+        // =====================================================
+        // FAULT LOOP
+        // =====================================================
+        for (int f = 0; f < totalFault; ++f)
+        {
+            if (idx + 4 > raw.size())
+                break;
 
-            // ---------------- TIME ----------------
-            quint8 hh = d[idx++];
-            quint8 mm = d[idx++];
-            quint8 ss = d[idx++];
-
-            QDateTime pktTime(
-                QDate(2000 + year, month, day),
-                QTime(hh, mm, ss)
-                );
-
-            // if (!pktTime.isValid())
-            //     continue;
-
-            // OPTIONAL time filter (uncomment if needed)
-            /*
-            if (pktTime < fromDt || pktTime > toDt)
-                continue;
-            */
-
-            // ---------------- SUBSYSTEM TYPE ----------------
-            quint8 subsystemType = d[idx++];
-
-            // ---------------- FAULT COUNT ----------------
-            quint8 totalFault = d[idx++];
-            if (totalFault > 10)
-                continue;
-            // ---- CRC VALIDATION ----
-            quint32 receivedCrc =
-                (d[raw.size()-4] << 24) |
-                (d[raw.size()-3] << 16) |
-                (d[raw.size()-2] << 8)  |
-                d[raw.size()-1];
+            quint8 moduleId = d[idx++];
+            quint8 type     = d[idx++];
+            quint16 code    =
+                (d[idx] << 8) | d[idx + 1];
+            idx += 2;
 
-            // Exclude SOF (first 2 bytes) and CRC (last 4 bytes)
-            QByteArray crcData = raw.mid(2, raw.size() - 6);
+            QJsonObject row;
 
-            quint32 calculatedCrc = calculateCRC32(crcData);
+            row["sof"] = isStation ? "AAAA" : "BBBB";
+            row["fault_origin"] =
+                isStation ? "STATION" : "LOCO";
 
-            // if (receivedCrc != calculatedCrc)
-            //     continue;
+            row["event_time"] = pktTime.toString("yyyy-MM-dd HH:mm:ss");
 
 
 
-            // =====================================================
-            // FAULT LOOP
-            // =====================================================
-            for (int f = 0; f < totalFault; ++f)
-            {
-                if (idx + 4 > raw.size())
-                    break;
+            row["packet_type"] = 0x19;
 
-                quint8 moduleId = d[idx++];
-                quint8 type     = d[idx++];
-                quint16 code    =
-                    (d[idx] << 8) | d[idx + 1];
-                idx += 2;
+            row["message_sequence"] = JNUM(msgSeq);
+            row["kavach_subsystem_id"] = JNUM(kavachId);
+            row["nms_system_id"] = JNUM(nmsId);
+            row["system_version"] = JNUM(version);
 
-                QJsonObject row;
 
-                row["sof"] = isStation ? "AAAA" : "BBBB";
-                row["fault_origin"] =
-                    isStation ? "STATION" : "LOCO";
+            QString moduleHex =
+                QString("%1")
+                    .arg(moduleId, 2, 16, QChar('0'))
+                    .toUpper();
 
-                row["event_time"] = pktTime.toString("yyyy-MM-dd HH:mm:ss");
+            QString subsystemHex =
+                QString("%1")
+                    .arg(subsystemType, 2, 16, QChar('0'))
+                    .toUpper();
 
+            row["fault_module_id"] = moduleHex;
+            row["subsystem_type"] = subsystemHex;
 
 
-                row["packet_type"] = 0x19;
+            QString faultCodeHex =
+                QString("%1")
+                    .arg(code, 4, 16, QChar('0'))
+                    .toUpper();
 
-                row["message_sequence"] = JNUM(msgSeq);
-                row["kavach_subsystem_id"] = JNUM(kavachId);
-                row["nms_system_id"] = JNUM(nmsId);
-                row["system_version"] = JNUM(version);
+            row["fault_code"] = faultCodeHex;
 
 
-                QString moduleHex =
-                    QString("%1")
-                        .arg(moduleId, 2, 16, QChar('0'))
-                        .toUpper();
+            QString faultTypeHex =
+                QString("%1")
+                    .arg(type, 2, 16, QChar('0'))
+                    .toUpper();
 
-                QString subsystemHex =
-                    QString("%1")
-                        .arg(subsystemType, 2, 16, QChar('0'))
-                        .toUpper();
+            row["fault_type"] = faultTypeHex;
 
-                row["fault_module_id"] = moduleHex;
-                row["subsystem_type"] = subsystemHex;
 
+            row["data_source"] = "BIN";
 
-                QString faultCodeHex =
-                    QString("%1")
-                        .arg(code, 4, 16, QChar('0'))
-                        .toUpper();
+            if (!out(row))
+                return;
+        }
+    };
 
-                row["fault_code"] = faultCodeHex;
+    // =====================================================
+    // FILE LOOP
+    // =====================================================
+    QStringList paths;
+    for (const QString& file : files)
+    {
+        QString fullPath = folder + "/" + file;
 
+        QDate fileDate = parseFileDate(fullPath);
+        if (!fileDate.isValid())
+            continue;
 
-                QString faultTypeHex =
-                    QString("%1")
-                        .arg(type, 2, 16, QChar('0'))
-                        .toUpper();
+        if (fileDate < fromDt.date() || fileDate > toDt.date())
+            continue;
 
-                row["fault_type"] = faultTypeHex;
+        paths.append(fullPath);
+    }
 
+    // Streamed: days one after another on this thread, each row handed
+    // to the sink as it is decoded so nothing accumulates
+    if (sink)
+    {
+        qint64 total = 0;
+        bool open = true;
 
-                row["data_source"] = "BIN";
+        const RowSink counted = [&](const QJsonObject& row) {
+            open = sink(row);
+            total += open;
+            return open;
+        };
 
-                rows.append(row);
-            }
+        for (const QString& path : paths)
+        {
+            LogScanner scanner;
+            auto handler = [&](const LogPacket& pkt) {
+                if (open)
+                    onFault(pkt, counted);
+            };
+            scanner.on(LogScanner::SOF_AAAA, 0x19, handler)
+                   .on(LogScanner::SOF_BBBB, 0x19, handler);
+            scanner.scanFile(path);
+
+            if (!open)
+                break;
         }
+
+        return {{"success", true}, {"totalRows", JNUM(total)}};
     }
 
+    // Days are decoded concurrently, rows merged in file order
+    const QVector<QJsonArray> days = LogParallel::scanDays<QJsonArray>(
+        paths, [&](LogScanner& scanner, QJsonArray& dayRows, int)
+    {
+        const RowSink collect = [&dayRows](const QJsonObject& row) {
+            dayRows.append(row);
+            return true;
+        };
+        auto handler = [&, collect](const LogPacket& pkt) { onFault(pkt, collect); };
+        scanner.on(LogScanner::SOF_AAAA, 0x19, handler)
+               .on(LogScanner::SOF_BBBB, 0x19, handler);
+    });
+
+    for (const QJsonArray& dayRows : days)
+        for (const QJsonValue& row : dayRows)
+            rows.append(row);
+
     return {
         {"success", true},
         {"data", rows}
@@ -3,12 +3,16 @@
 #include <QJsonObject>
 #include <QString>
 
+#include "row_sink.h"
+
 class BackendLocoFault {
 public:
     static QJsonObject fetchByDateRange(
         const QString& fromDate,
         const QString& toDate,
-        const QString& logDir
+        const QString& logDir,
+        bool validateCrc = true,   // LVKFaultParser::crcOk()
+        const RowSink& sink = {}   // stream rows instead of returning "data"
         );
 
 private:
@@ -6,12 +6,12 @@
 #include <QJsonArray>
 #include <iostream>
 #include <QUrl>
-#include "dbconfig.h"
+#include "db_pool.h"
+#include "sql_row_mapper.h"
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QIODevice>
-#include <QTextStream>
 #include <QDate>
 #include <QDateTime>
 #include <QJsonArray>
@@ -20,29 +20,13 @@
 #undef QT_NO_DEBUG_OUTPUT
 #include "lvk_pos_info_packet.h"
 #include "lvk_pos_info_parser.h"
+#include "lvk_pos_info_view.h"
+#include "log_scanner.h"
 
 #define JNUM(x) QJsonValue(static_cast<qint64>(x))
 #define JBOOL(x) QJsonValue(static_cast<bool>(x))
 
 
-// =====================================================
-// SAFE DATABASE OPENER (SQL SERVER)
-// =====================================================
-static QSqlDatabase openDatabase()
-{
-    if (QSqlDatabase::contains(DB_CONN_NAME)) {
-        return QSqlDatabase::database(DB_CONN_NAME);
-    }
-
-    QSqlDatabase db = QSqlDatabase::addDatabase("QODBC", DB_CONN_NAME);
-    db.setDatabaseName(DB_CONNECTION_STRING);
-
-    if (!db.open()) {
-        qDebug() << "DB open failed:" << db.lastError().text();
-    }
-
-    return db;
-}
 
 
 
@@ -80,55 +64,52 @@ QJsonObject BackendLocoMovement::fetchByDateRange(
         };
     }
 
-    QByteArray content = fileData;
-    QList<QByteArray> lines = content.split('\n');
-
+    const qint64 fromSecs = LVKPosInfoView::wallSeconds(fromDt);
+    const qint64 toSecs   = LVKPosInfoView::wallSeconds(toDt);
 
-    for (const QByteArray &lineRaw : lines)
+    // Frames are split out of fileData in place and decoded one at a
+    // time into the scanner's buffer
+    LogScanner scanner;
+    scanner.on(0x12, [&](const LogPacket &pkt)
     {
-        QString line = QString::fromLatin1(lineRaw).trimmed();
+        // Header + time straight from the bytes; nothing is decoded
+        // for packets outside the range
+        const LVKPosInfoView view(pkt.data, pkt.length);
 
-        if (!line.startsWith("AAAA12"))
-            continue;
+        if (!view.isValid())
+            return;
 
-        QByteArray data = QByteArray::fromHex(line.toLatin1());
-        if (data.size() < 3)
-            continue;
+        const qint64 pktSecs = view.wallSeconds();
+        if (pktSecs < 0)
+            return;
 
-        LVKPosInfoPacket pkt;
+        if (pktSecs < fromSecs || pktSecs > toSecs)
+            return;
 
-        try {
-            pkt = LVKPosInfoParser::parse(
-                reinterpret_cast<const quint8*>(data.constData()),
-                data.size());
-        } catch (...) {
-            continue;
-        }
-
-        if (!pkt.IsDateTimeValid)
-            continue;
-
-        if (pkt.PacketDateTime < fromDt ||
-            pkt.PacketDateTime > toDt)
-            continue;
+        const int packetType = view.packetType();
 
         QJsonObject row;
-        row["event_time"] = pkt.PacketDateTime.toString(Qt::ISODate);
-        row["packet_type"] = JNUM(pkt.PacketType);
-
-        row["message_sequence"]        = JNUM(pkt.MessageSequence);
-        row["stationary_kavach_id"]    = JNUM(pkt.StationaryKavachId);
-        row["nms_system_id"]           = JNUM(pkt.NmsSystemId);
-        row["system_version"]          = JNUM(pkt.SystemVersion);
-        row["active_radio"]            = JNUM(pkt.ActiveRadio);
-        row["route_id"]                = JNUM(pkt.RouteId);
-        row["ma_section_count"]        = JNUM(pkt.NoOfMASections);
+        row["event_time"] = view.dateTime().toString(Qt::ISODate);
+        row["packet_type"] = JNUM(packetType);
+
+        row["message_sequence"]        = JNUM(view.messageSequence());
+        row["stationary_kavach_id"]    = JNUM(view.stationaryKavachId());
+        row["nms_system_id"]           = JNUM(view.nmsSystemId());
+        row["system_version"]          = JNUM(view.systemVersion());
+        row["active_radio"]            = JNUM(view.activeRadio());
+        row["route_id"]                = JNUM(view.routeId());
+        row["ma_section_count"]        = JNUM(view.noOfMASections());
         row["data_source"]             = "BIN";
 
 
-        if (pkt.PacketType == 0xA) {
+        if (packetType == 0xA) {
             // ===== ONBOARD =====
-            const auto& m = pkt.RadioPacket;
+            OnboardRegularPacketModel m;
+            try {
+                LVKPosInfoParser::decodeRegular(view, m);
+            } catch (...) {
+                return;
+            }
 
             row["frame_number"]            = JNUM(m.FrameNumber);
             row["source_loco_id"]          = JNUM(m.SourceLocoId);
@@ -160,11 +141,16 @@ QJsonObject BackendLocoMovement::fetchByDateRange(
 
         }
 
-        else if (pkt.PacketType == 0xD) {
+        else if (packetType == 0xD) {
             // ===== ACCESS =====
-            const auto& a = pkt.ARRadioPacket;
-
-            row["packet_type"]             = JNUM(pkt.PacketType);
+            OnboardAccessRequestPacketModel a;
+            try {
+                LVKPosInfoParser::decodeAccessRequest(view, a);
+            } catch (...) {
+                return;
+            }
+
+            row["packet_type"]             = JNUM(packetType);
             row["frame_number"]            = JNUM(a.FrameNumber);
             row["source_loco_id"]          = JNUM(a.SourceLocoId);
             row["source_loco_version"]     = JNUM(a.SourceLocoVersion);
@@ -189,8 +175,9 @@ QJsonObject BackendLocoMovement::fetchByDateRange(
 
         row["data_source"] = "UPLOAD";
         rows.append(row);
+    });
 
-    }
+    scanner.scanBuffer(fileData);
 
     return {{"success", true}, {"data", rows}};
 }
@@ -222,28 +209,31 @@ QDate BackendLocoMovement::parseFileDate(const QString &fileName) {
 QJsonObject BackendLocoMovement::fetchLatest(int limit)
 {
     QJsonArray rows;
-    QSqlDatabase db = openDatabase();
-
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
-
-    QSqlQuery q(db);
-    q.exec(
-        QString(
-            "SELECT TOP(%1) * FROM loco_movement_logs "
-            "ORDER BY event_time DESC"
-            ).arg(limit)
-        );
-    QSqlRecord rec = q.record();
-    while (q.next()) {
-        QJsonObject row;
-        for (int i = 0; i < rec.count(); ++i)
-            row[rec.fieldName(i)] = q.value(i).toString();
-        rows.append(row);
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    // Constant SQL text, so the statement stays prepared on the connection
+    QSqlError error;
+    DbConnection::Statement q = conn.prepare(
+        "SELECT TOP(?) * FROM loco_movement_logs "
+        "ORDER BY event_time DESC",
+        error);
+    if (!q)
+        return {{"success", false}, {"error", error.text()}};
+
+    q->bindValue(0, qMax(0, limit));
+    if (!q->exec()) {
+        error = q->lastError();
+        q->finish();
+        return {{"success", false}, {"error", error.text()}};
     }
 
-    db.close();
-    QSqlDatabase::removeDatabase("loco_latest");
+    // Columns resolved once; values keep their SQL types
+    const SqlRowMapper mapper(q->record());
+    while (q->next())
+        rows.append(mapper.map(*q));
+    q->finish();
 
     return {{"success", true}, {"data", rows}};
 }
@@ -7,33 +7,19 @@
 #include <QJsonArray>
 #include <iostream>
 #include <QUrl>
-#include "dbconfig.h"
-// =====================================================
-// SAFE DATABASE OPENER (SQL SERVER)
-// =====================================================
-static QSqlDatabase openDatabase()
-{
-    if (QSqlDatabase::contains(DB_CONN_NAME)) {
-        return QSqlDatabase::database(DB_CONN_NAME);
-    }
-
-    QSqlDatabase db = QSqlDatabase::addDatabase("QODBC", DB_CONN_NAME);
-    db.setDatabaseName(DB_CONNECTION_STRING);
-
-    if (!db.open()) {
-        qDebug() << "DB open failed:" << db.lastError().text();
-    }
-
-    return db;
-}
+#include "db_pool.h"
+#include "fault_listing.h"
+#include "fault_rollup.h"
 // =====================================================
 // CREATE TABLE
 // =====================================================
 QJsonObject BackendRFCOMFault::initTable()
 {
-    QSqlDatabase db = openDatabase();
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    QSqlDatabase db = conn.database();
 
     QSqlQuery q(db);
     q.exec("DROP TABLE IF EXISTS rfcom_fault_logs");
@@ -51,12 +37,35 @@ QJsonObject BackendRFCOMFault::initTable()
         ")"
         );
 
-    db.close();
-    QSqlDatabase::removeDatabase("rfcom_init");
+    // Indexes for the keyset listing
+    QString error;
+    if (ok && !FaultListing::createIndexes(db, "rfcom_fault_logs", error))
+        return {{"success", false}, {"error", error}};
+
+    // The old rows are gone; so are their counts
+    if (ok && !FaultRollup::clear(db, FaultRollup::Rfcom, error))
+        return {{"success", false}, {"error", error}};
 
     return {{"success", ok}};
 }
 
+// Listing row (columns as in FaultListing::RowFn)
+static QJsonObject faultRow(const QSqlQuery &q)
+{
+    QJsonObject row;
+    const QString ts = q.value(1).toString();
+    const QStringList parts = ts.split(" ");
+
+    row["date"]      = parts.value(0);
+    row["time"]      = parts.value(1);
+    row["locoId"]    = q.value(2).toString();
+    row["station"]   = q.value(3).toString();
+    row["faultCode"] = q.value(4).toString();
+    row["description"] = q.value(5).toString();
+    row["status"]    = q.value(6).toString();
+    return row;
+}
+
 // =====================================================
 // FETCH RFCOM FAULTS
 // =====================================================
@@ -66,62 +75,27 @@ QJsonObject BackendRFCOMFault::getFaults(
     int limit
     )
 {
-    QJsonArray rows;
-    QSqlDatabase db = openDatabase();
-
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
-
-    int offset = (page - 1) * limit;
-
-    QSqlQuery q(db);
-    q.prepare(
-        "SELECT event_time, loco_id, station_code, "
-        "fault_code, description, status "
-        "FROM rfcom_fault_logs "
-        "WHERE (:station IS NULL OR station_code = :station) "
-        "ORDER BY event_time DESC "
-        "OFFSET :offset ROWS FETCH NEXT :limit ROWS ONLY"
-        );
-
-    if (station.isEmpty())
-        q.bindValue(":station", QVariant(QVariant::String));
-    else
-        q.bindValue(":station", station);
-
-    q.bindValue(":offset", offset);
-    q.bindValue(":limit", limit);
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
 
-    if (!q.exec()) {
-        db.close();
-        return {{"success", false}, {"error", q.lastError().text()}};
-    }
-
-    while (q.next()) {
-        QJsonObject row;
-        const QString ts = q.value("event_time").toString();
-        const QStringList parts = ts.split(" ");
-
-        row["date"]      = parts.value(0);
-        row["time"]      = parts.value(1);
-        row["locoId"]    = q.value("loco_id").toString();
-        row["station"]   = q.value("station_code").toString();
-        row["faultCode"] = q.value("fault_code").toString();
-        row["description"] = q.value("description").toString();
-        row["status"]    = q.value("status").toString();
-
-        rows.append(row);
-    }
+    return FaultListing::fetchOffsetPage(conn, "rfcom_fault_logs", faultRow, station, page, limit);
+}
 
-    db.close();
-    QSqlDatabase::removeDatabase("rfcom_fetch");
+// =====================================================
+// FETCH RFCOM FAULTS (KEYSET, FROM CURSOR)
+// =====================================================
+QJsonObject BackendRFCOMFault::getFaultsFromCursor(
+    const QString &station,
+    const QString &cursor,
+    int limit
+    )
+{
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
 
-    return {
-        {"success", true},
-        {"data", rows},
-        {"page", page},
-        {"limit", limit}
-    };
+    return FaultListing::fetchPage(conn, "rfcom_fault_logs", faultRow, station, cursor, limit);
 }
 
 QJsonObject BackendRFCOMFault::getFaultsByDateRange(
@@ -131,11 +105,9 @@ QJsonObject BackendRFCOMFault::getFaultsByDateRange(
     )
 {
     QJsonArray rows;
-    QSqlDatabase db = openDatabase();
-
-    if (!db.open()) {
-        return {{"success", false}, {"error", db.lastError().text()}};
-    }
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
 
     // ---- Decode & normalize ----
     QString fromStr = QUrl::fromPercentEncoding(fromDate.toUtf8());
@@ -163,8 +135,6 @@ QJsonObject BackendRFCOMFault::getFaultsByDateRange(
     QDateTime toDt   = parseDate(toStr);
 
     if (!fromDt.isValid() || !toDt.isValid()) {
-        db.close();
-        // QSqlDatabase::removeDatabase("rfcom_range");
         return {
             {"success", false},
             {"error", "Invalid date format received from frontend"}
@@ -175,43 +145,30 @@ QJsonObject BackendRFCOMFault::getFaultsByDateRange(
     fromDt.setTime(QTime(fromDt.time().hour(), fromDt.time().minute(), 0));
     toDt.setTime(QTime(toDt.time().hour(), toDt.time().minute(), 59));
 
-    QSqlQuery q(db);
-    q.prepare(
-        "SELECT event_time, loco_id, station_code, fault_code, description, status "
+    QSqlError error;
+    DbConnection::Statement q = conn.prepare(
+        "SELECT id, event_time, loco_id, station_code, fault_code, description, status "
         "FROM rfcom_fault_logs "
         "WHERE station_code = ? "
         "AND event_time BETWEEN ? AND ? "
-        "ORDER BY event_time DESC"
-        );
-
-    q.addBindValue(station);
-    q.addBindValue(fromDt);
-    q.addBindValue(toDt);
-
-    if (!q.exec()) {
-        db.close();
-        // QSqlDatabase::removeDatabase("rfcom_range");
-        return {{"success", false}, {"error", q.lastError().text()}};
-    }
-
-    while (q.next()) {
-        const QString ts = q.value("event_time").toString();
-        const QStringList parts = ts.split(" ");
-
-        QJsonObject row;
-        row["date"]        = parts.value(0);
-        row["time"]        = parts.value(1);
-        row["locoId"]      = q.value("loco_id").toString();
-        row["station"]     = q.value("station_code").toString();
-        row["faultCode"]   = q.value("fault_code").toString();
-        row["description"] = q.value("description").toString();
-        row["status"]      = q.value("status").toString();
-
-        rows.append(row);
+        "ORDER BY event_time DESC",
+        error);
+    if (!q)
+        return {{"success", false}, {"error", error.text()}};
+
+    q->bindValue(0, station);
+    q->bindValue(1, fromDt);
+    q->bindValue(2, toDt);
+
+    if (!q->exec()) {
+        error = q->lastError();
+        q->finish();
+        return {{"success", false}, {"error", error.text()}};
     }
 
-    db.close();
-    // QSqlDatabase::removeDatabase("rfcom_range");
+    while (q->next())
+        rows.append(faultRow(*q));
+    q->finish();
 
     return {
         {"success", true},
@@ -225,8 +182,18 @@ QJsonObject BackendRFCOMFault::getFaultsByDateRange(
 // =====================================================
 QJsonObject BackendRFCOMFault::insertFault(const QJsonObject &p)
 {
-    QSqlDatabase db = openDatabase();
-    if (!db.open())
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    QSqlDatabase db = conn.database();
+
+    // Row and rollup count commit together
+    QString error;
+    if (!FaultRollup::ensureTable(db, error))
+        return {{"success", false}, {"error", error}};
+
+    if (!db.transaction())
         return {{"success", false}, {"error", db.lastError().text()}};
 
     QSqlQuery q(db);
@@ -244,21 +211,40 @@ QJsonObject BackendRFCOMFault::insertFault(const QJsonObject &p)
     q.addBindValue(p.value("description").toString());
     q.addBindValue(p.value("status").toString());
 
-    bool ok = q.exec();
-    db.close();
-    QSqlDatabase::removeDatabase("rfcom_insert");
+    if (!q.exec()) {
+        QString err = q.lastError().text();
+        db.rollback();
+        return {{"success", false}, {"error", err}};
+    }
+
+    FaultRollupDelta delta;
+    delta.add(p.value("station_code").toString(),
+              FaultRollup::dayOf(p.value("event_time").toString()));
+
+    QSqlError rollupError;
+    if (!FaultRollup::apply(db, FaultRollup::Rfcom, delta, rollupError)) {
+        db.rollback();
+        return {{"success", false}, {"error", rollupError.text()}};
+    }
+
+    if (!db.commit()) {
+        QString err = db.lastError().text();
+        db.rollback();
+        return {{"success", false}, {"error", err}};
+    }
 
-    return ok ? QJsonObject{{"success", true}}
-              : QJsonObject{{"success", false}, {"error", q.lastError().text()}};
+    return {{"success", true}};
 }
 // =====================================================
 // FETCH DISTINCT RFCOM STATIONS
 // =====================================================
 QJsonObject BackendRFCOMFault::getStations()
 {
-    QSqlDatabase db = openDatabase();
-    if (!db.open())
-        return {{"success", false}, {"error", db.lastError().text()}};
+    DbConnection conn;
+    if (!conn.isValid())
+        return {{"success", false}, {"error", conn.error()}};
+
+    QSqlDatabase db = conn.database();
 
     QSqlQuery q(db);
     QJsonArray stations;
@@ -269,7 +255,6 @@ QJsonObject BackendRFCOMFault::getStations()
             "WHERE station_code IS NOT NULL "
             "ORDER BY station_code"
             )) {
-        db.close();
         return {{"success", false}, {"error", q.lastError().text()}};
     }
 
@@ -277,8 +262,6 @@ QJsonObject BackendRFCOMFault::getStations()
         stations.append(q.value(0).toString());
     }
 
-    db.close();
-    QSqlDatabase::removeDatabase("rfcom_stations");
 
     return {
         {"success", true},
@@ -1,8 +1,9 @@
 #include "backend_stationary_health.h"
+#include "log_parallel.h"
+#include "log_scanner.h"
 
-#include <QFile>
 #include <QDir>
-#include <QTextStream>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QDateTime>
 #include <QUrl>
@@ -61,151 +62,160 @@ QJsonObject BackendStationaryHealth::processBinFiles(
     QStringList files =
         QDir(folder).entryList({"*.bin"}, QDir::Files);
 
-    for (const QString& file : files)
+    // One packet of the day 'fileDate' (reported per row)
+    auto onPacket = [expectedMsgType](const LogPacket& pkt, const QDate& fileDate,
+                                      QJsonArray& rows)
     {
+        const QByteArrayView raw(reinterpret_cast<const char*>(pkt.data), pkt.length);
 
-        QString base = QFileInfo(file).baseName();
-        QStringList parts = base.split('-');
+        if (raw.size() < 20)
+            return;
 
-        if (parts.size() != 3)
-            continue;
+        quint8 msgType = static_cast<quint8>(raw[2]);
 
-        QDate fileDate(
-            2000 + parts[2].toInt(),
-            parts[1].toInt(),
-            parts[0].toInt());
+        if (msgType != expectedMsgType)
+            return;
 
-        if (!fileDate.isValid())
-            continue;
+        QJsonObject row;
 
-        if (fileDate < fromD || fileDate > toD)
-            continue;
+        row["file_date"] = fileDate.toString("yyyy-MM-dd");
+        row["msg_type"] = JNUM(msgType);
+        row["msg_length"] =
+            JNUM((static_cast<quint8>(raw[3]) << 8) |
+                 static_cast<quint8>(raw[4]));
 
-        QFile f(folder + "/" + file);
-        if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
-            continue;
+        row["msg_sequence"] =
+            JNUM((static_cast<quint8>(raw[5]) << 8) |
+                 static_cast<quint8>(raw[6]));
 
-        QTextStream in(&f);
 
-        while (!in.atEnd())
-        {
-            QString line = in.readLine().trimmed();
-            if (line.isEmpty())
-                continue;
 
-            if (!line.startsWith("AAAA"))
-                continue;
 
-            QByteArray raw = QByteArray::fromHex(line.toLatin1());
 
-            if (raw.size() < 20)
-                continue;
+        int index = 7;
 
-            quint8 msgType = static_cast<quint8>(raw[2]);
+        // Stationary KAVACH ID (2)
+        row["stationary_kavach_id"] =
+            JNUM((static_cast<quint8>(raw[index]) << 8) |
+                 static_cast<quint8>(raw[index+1]));
+        index += 2;
 
-            if (msgType != expectedMsgType)
-                continue;
+        // NMS System ID (2)
+        row["nms_system_id"] =
+            JNUM((static_cast<quint8>(raw[index]) << 8) |
+                 static_cast<quint8>(raw[index+1]));
+        index += 2;
 
-            QJsonObject row;
+        // System Version (1)
+        row["system_version"] =
+            JNUM(static_cast<quint8>(raw[index]));
+        index += 1;
 
-            row["file_date"] = fileDate.toString("yyyy-MM-dd");
-            row["msg_type"] = JNUM(msgType);
-            row["msg_length"] =
-                JNUM((static_cast<quint8>(raw[3]) << 8) |
-                     static_cast<quint8>(raw[4]));
+        // Skip Date (3) + Time (3)
+        index += 6;
 
-            row["msg_sequence"] =
-                JNUM((static_cast<quint8>(raw[5]) << 8) |
-                     static_cast<quint8>(raw[6]));
 
+        quint8 eventCount = raw[index++];
+        row["event_count"] = JNUM(eventCount);
 
+        QJsonArray events;
 
+        for (int i = 0; i < eventCount; ++i)
+        {
+            if (index + 1 >= raw.size())
+                break;
 
+            quint16 eventId =
+                (static_cast<quint8>(raw[index]) << 8) |
+                static_cast<quint8>(raw[index+1]);
+            index += 2;
 
-            int index = 7;
+            int dataSize =
+                (msgType == 0x17)
+                    ? getEventDataSize_0x17(eventId)
+                    : getEventDataSize_0x18(eventId);
 
-            // Stationary KAVACH ID (2)
-            row["stationary_kavach_id"] =
-                JNUM((static_cast<quint8>(raw[index]) << 8) |
-                     static_cast<quint8>(raw[index+1]));
-            index += 2;
+            if (dataSize <= 0)
+                break;
 
-            // NMS System ID (2)
-            row["nms_system_id"] =
-                JNUM((static_cast<quint8>(raw[index]) << 8) |
-                     static_cast<quint8>(raw[index+1]));
-            index += 2;
+            if (index + dataSize > raw.size())
+                break;
 
-            // System Version (1)
-            row["system_version"] =
-                JNUM(static_cast<quint8>(raw[index]));
-            index += 1;
+            QJsonObject ev;
+            ev["event_id"] = JNUM(eventId);
 
-            // Skip Date (3) + Time (3)
-            index += 6;
+            if (dataSize == 1)
+            {
+                ev["event_data"] =
+                    JNUM(static_cast<quint8>(raw[index]));
+            }
+            else if (dataSize == 2)
+            {
+                ev["event_data"] =
+                    JNUM((static_cast<quint8>(raw[index]) << 8) |
+                         static_cast<quint8>(raw[index+1]));
+            }
+            else if (dataSize == 4)
+            {
+                ev["event_data"] =
+                    JNUM((static_cast<quint8>(raw[index]) << 24) |
+                         (static_cast<quint8>(raw[index+1]) << 16) |
+                         (static_cast<quint8>(raw[index+2]) << 8) |
+                         static_cast<quint8>(raw[index+3]));
+            }
 
+            index += dataSize;
 
-            quint8 eventCount = raw[index++];
-            row["event_count"] = JNUM(eventCount);
+            events.append(ev);
+        }
 
-            QJsonArray events;
 
-            for (int i = 0; i < eventCount; ++i)
-            {
-                if (index + 1 >= raw.size())
-                    break;
-
-                quint16 eventId =
-                    (static_cast<quint8>(raw[index]) << 8) |
-                    static_cast<quint8>(raw[index+1]);
-                index += 2;
-
-                int dataSize =
-                    (msgType == 0x17)
-                        ? getEventDataSize_0x17(eventId)
-                        : getEventDataSize_0x18(eventId);
-
-                if (dataSize <= 0)
-                    break;
-
-                if (index + dataSize > raw.size())
-                    break;
-
-                QJsonObject ev;
-                ev["event_id"] = JNUM(eventId);
-
-                if (dataSize == 1)
-                {
-                    ev["event_data"] =
-                        JNUM(static_cast<quint8>(raw[index]));
-                }
-                else if (dataSize == 2)
-                {
-                    ev["event_data"] =
-                        JNUM((static_cast<quint8>(raw[index]) << 8) |
-                             static_cast<quint8>(raw[index+1]));
-                }
-                else if (dataSize == 4)
-                {
-                    ev["event_data"] =
-                        JNUM((static_cast<quint8>(raw[index]) << 24) |
-                             (static_cast<quint8>(raw[index+1]) << 16) |
-                             (static_cast<quint8>(raw[index+2]) << 8) |
-                             static_cast<quint8>(raw[index+3]));
-                }
-
-                index += dataSize;
-
-                events.append(ev);
-            }
+        row["events"] = events;
 
+        rows.append(row);
+    };
 
-            row["events"] = events;
+    QStringList paths;
+    QVector<QDate> dates;
 
-            rows.append(row);
-        }
+    for (const QString& file : files)
+    {
+
+        QString base = QFileInfo(file).baseName();
+        QStringList parts = base.split('-');
+
+        if (parts.size() != 3)
+            continue;
+
+        QDate fileDate = QDate(
+            2000 + parts[2].toInt(),
+            parts[1].toInt(),
+            parts[0].toInt());
+
+        if (!fileDate.isValid())
+            continue;
+
+        if (fileDate < fromD || fileDate > toD)
+            continue;
+
+        paths.append(folder + "/" + file);
+        dates.append(fileDate);
     }
 
+    // Days are decoded concurrently, rows merged in file order
+    const QVector<QJsonArray> days = LogParallel::scanDays<QJsonArray>(
+        paths, [&](LogScanner& scanner, QJsonArray& dayRows, int n)
+    {
+        const QDate fileDate = dates.at(n);
+        scanner.on(expectedMsgType, [&, fileDate](const LogPacket& pkt) {
+            onPacket(pkt, fileDate, dayRows);
+        });
+    });
+
+    for (const QJsonArray& dayRows : days)
+        for (const QJsonValue& row : dayRows)
+            rows.append(row);
+
     return {{"success", true}, {"data", rows}};
 }
 
@@ -4,6 +4,8 @@
 #include <QString>
 #include <QDate>
 
+#include "row_sink.h"
+
     class BackendStationaryKavach
 {
 public:
@@ -11,20 +13,23 @@ public:
     static QJsonObject fetchRegular(
         const QString& fromDate,
         const QString& toDate,
-        const QByteArray& fileData
+        const QByteArray& fileData,
+        const RowSink& sink = {}   // stream rows instead of returning "data"
         );
 
 
     static QJsonObject fetchAccess(
         const QString& fromDate,
         const QString& toDate,
-        const QByteArray& fileData
+        const QByteArray& fileData,
+        const RowSink& sink = {}   // stream rows instead of returning "data"
         );
 
     static QJsonObject fetchEmergency(
         const QString& fromDate,
         const QString& toDate,
-        const QByteArray& fileData
+        const QByteArray& fileData,
+        const RowSink& sink = {}   // stream rows instead of returning "data"
         );
 
 private:
@@ -33,7 +38,8 @@ private:
         const QString& fromDate,
         const QString& toDate,
         const QByteArray& fileData,
-        int expectedPktTypeBits
+        int expectedPktTypeBits,
+        const RowSink& sink
         );
 
 
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "lvk_pos_info_packet.h"
+#include <QByteArray>
+#include <QString>
+
+// LVKPosInfoParser as of 1a22acd (bit fields read through a QString of
+// '0' / '1' characters), kept as the baseline for main.cpp
+
+class BaselinePosInfoParser
+{
+public:
+    static LVKPosInfoPacket parse(const quint8* data, int length);
+
+private:
+    static quint8  readU8 (const quint8* d, int& i, int len);
+    static quint16 readU16(const quint8* d, int& i, int len);
+    static quint32 readU32(const quint8* d, int& i, int len);
+
+    static QString bytesToBitString(const QByteArray& data);
+    static quint32 readBits(const QString& bits, int& pos, int length);
+
+    static void parseRegularPacket(const QByteArray& d, int& i, OnboardRegularPacketModel& m);
+    static void parseAccessRequest(const QByteArray& d, int& i, OnboardAccessRequestPacketModel& m);
+};
@@ -0,0 +1,158 @@
+#include "baseline_pos_info_parser.h"
+#include "lvk_pos_info_parser.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QVector>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * Old (1a22acd) vs current LVKPosInfoParser over a synthetic day of
+ * AAAA12 frames: one frame a second, three regular packets to one
+ * access request, random radio payload with a fixed seed.
+ *
+ *   qmake && make && ./pos_info_parse [frames] [rounds]
+ *
+ * Prints the best round of each parser and the number of frames whose
+ * decoded fields differ between the two (must be 0).
+ */
+
+namespace {
+
+constexpr int FRAME_SIZE = 80;
+
+QVector<QByteArray> syntheticDay(int count)
+{
+    QRandomGenerator rng(0x12);
+    QVector<QByteArray> frames;
+    frames.reserve(count);
+
+    for (int n = 0; n < count; ++n) {
+        QByteArray f(FRAME_SIZE, '\0');
+        auto *d = reinterpret_cast<quint8 *>(f.data());
+
+        for (int i = 0; i < FRAME_SIZE; ++i)
+            d[i] = quint8(rng.bounded(256));
+
+        const int second = n % 86400;
+        d[0] = 0xAA; d[1] = 0xAA;
+        d[2] = 0x12;
+        d[3] = 0; d[4] = FRAME_SIZE - 2;
+        d[5] = quint8(n >> 8); d[6] = quint8(n);
+        d[7] = 0x00; d[8] = 0x2A;
+        d[12] = 14; d[13] = 3; d[14] = 25;
+        d[15] = quint8(second / 3600);
+        d[16] = quint8(second / 60 % 60);
+        d[17] = quint8(second % 60);
+
+        const quint8 type = (n % 4 == 3) ? 0xD : 0xA;
+        d[21] = quint8((type << 4) | (d[21] & 0x0F));
+
+        frames.append(f);
+    }
+    return frames;
+}
+
+bool sameFields(const LVKPosInfoPacket &a, const LVKPosInfoPacket &b)
+{
+    if (a.PacketType != b.PacketType ||
+        a.MessageSequence != b.MessageSequence ||
+        a.StationaryKavachId != b.StationaryKavachId ||
+        a.PacketDateTime != b.PacketDateTime ||
+        a.NoOfMASections != b.NoOfMASections ||
+        a.RouteId != b.RouteId)
+        return false;
+
+    if (a.PacketType == 0xA) {
+        const OnboardRegularPacketModel &x = a.RadioPacket, &y = b.RadioPacket;
+        return x.FrameNumber == y.FrameNumber &&
+               x.SourceLocoId == y.SourceLocoId &&
+               x.AbsoluteLocoLocation == y.AbsoluteLocoLocation &&
+               x.TrainSpeed == y.TrainSpeed &&
+               x.MovementDir == y.MovementDir &&
+               x.LocoMode == y.LocoMode &&
+               x.EmergencyStatus == y.EmergencyStatus &&
+               x.InfoAck == y.InfoAck &&
+               x.OnboardHealthBytes[0] == y.OnboardHealthBytes[0] &&
+               x.OnboardHealthBytes[1] == y.OnboardHealthBytes[1] &&
+               x.OnboardHealthBytes[2] == y.OnboardHealthBytes[2];
+    }
+
+    const OnboardAccessRequestPacketModel &x = a.ARRadioPacket, &y = b.ARRadioPacket;
+    return x.FrameNumber == y.FrameNumber &&
+           x.SourceLocoId == y.SourceLocoId &&
+           x.AbsoluteLocoLocation == y.AbsoluteLocoLocation &&
+           x.TrainSpeed == y.TrainSpeed &&
+           x.ApprochingStationID == y.ApprochingStationID &&
+           x.Longitude == y.Longitude &&
+           x.Latitude == y.Latitude &&
+           x.LOCO_RND_NUM_RL == y.LOCO_RND_NUM_RL;
+}
+
+// Best of 'rounds' passes over all frames, in ns per frame
+template <typename Parse>
+double bestRound(const QVector<QByteArray> &frames, int rounds, Parse parse)
+{
+    qint64 best = -1;
+    quint64 sink = 0;
+
+    for (int r = 0; r < rounds; ++r) {
+        QElapsedTimer timer;
+        timer.start();
+
+        for (const QByteArray &f : frames) {
+            const LVKPosInfoPacket pkt =
+                parse(reinterpret_cast<const quint8 *>(f.constData()), int(f.size()));
+            sink += pkt.RadioPacket.FrameNumber + pkt.ARRadioPacket.FrameNumber;
+        }
+
+        const qint64 ns = timer.nsecsElapsed();
+        if (best < 0 || ns < best)
+            best = ns;
+    }
+
+    // Keep the work observable
+    if (sink == 1)
+        std::puts("");
+
+    return double(best) / frames.size();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 86400;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    const QVector<QByteArray> frames = syntheticDay(count);
+
+    int mismatches = 0;
+    for (const QByteArray &f : frames) {
+        const auto *d = reinterpret_cast<const quint8 *>(f.constData());
+        if (!sameFields(BaselinePosInfoParser::parse(d, int(f.size())),
+                        LVKPosInfoParser::parse(d, int(f.size()))))
+            ++mismatches;
+    }
+
+    const double oldNs = bestRound(frames, rounds, [](const quint8 *d, int len) {
+        return BaselinePosInfoParser::parse(d, len);
+    });
+    const double newNs = bestRound(frames, rounds, [](const quint8 *d, int len) {
+        return LVKPosInfoParser::parse(d, len);
+    });
+
+    QTextStream out(stdout);
+    out << "frames:     " << count << " x " << rounds << " rounds\n"
+        << "baseline:   " << oldNs << " ns/frame, "
+        << qint64(1e9 / oldNs) << " frames/s\n"
+        << "BitReader:  " << newNs << " ns/frame, "
+        << qint64(1e9 / newNs) << " frames/s\n"
+        << "speedup:    " << oldNs / newNs << "x\n"
+        << "mismatches: " << mismatches << "\n";
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+QT += core
+QT -= gui
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+
+TARGET = pos_info_parse
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    baseline_pos_info_parser.cpp \
+    main.cpp \
+    ../../lvk_pos_info_parser.cpp
+
+HEADERS += \
+    baseline_pos_info_parser.h \
+    ../../bit_reader.h \
+    ../../lvk_pos_info_packet.h \
+    ../../lvk_pos_info_parser.h \
+    ../../lvk_pos_info_view.h
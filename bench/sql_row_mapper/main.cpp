@@ -0,0 +1,158 @@
+#include "sql_row_mapper.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTextStream>
+#include <QVariant>
+#include <cstdlib>
+
+/*
+ * Rows/second of the two ways the backends turned a result set into
+ * JSON, over 'rows' rows of loco_movement_logs (the LogIngest schema)
+ * in an in-memory SQLite database:
+ *
+ *   record+name  q.record() per row, every column looked up by name and
+ *                converted through toString() (the pre-SqlRowMapper
+ *                backends)
+ *   mapper       SqlRowMapper resolved once after exec(), map() per row
+ *                (BackendLocoMovement::fetchLatest)
+ *
+ *   qmake && make && ./sql_row_mapper_bench [rows] [rounds]
+ *
+ * SQLite only: fetchLatest itself runs TOP(?) on the SQL Server pool,
+ * here the same loop runs over SELECT * ... LIMIT ?. ODBC fetch costs
+ * are not part of the numbers.
+ */
+
+namespace {
+
+bool fill(QSqlDatabase &db, int rows)
+{
+    QSqlQuery q(db);
+    if (!q.exec("CREATE TABLE loco_movement_logs ("
+                "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                "event_time DATETIME NOT NULL,"
+                "station_code VARCHAR(16),"
+                "stationary_kavach_id INT,"
+                "packet_type INT,"
+                "loco_id INT,"
+                "frame_number INT,"
+                "absolute_loco_location INT,"
+                "train_speed_kmph INT,"
+                "movement_direction INT,"
+                "loco_mode INT,"
+                "emergency_status INT,"
+                "data_source VARCHAR(16),"
+                "created_at DATETIME DEFAULT CURRENT_TIMESTAMP)"))
+        return false;
+
+    db.transaction();
+    q.prepare("INSERT INTO loco_movement_logs (event_time, station_code, "
+              "stationary_kavach_id, packet_type, loco_id, frame_number, "
+              "absolute_loco_location, train_speed_kmph, movement_direction, "
+              "loco_mode, emergency_status, data_source) "
+              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    const QDateTime start(QDate(2025, 3, 14), QTime(0, 0));
+    for (int n = 0; n < rows; ++n) {
+        q.addBindValue(start.addSecs(n));
+        q.addBindValue(QStringLiteral("STN%1").arg(n % 40));
+        q.addBindValue(n % 40);
+        q.addBindValue(n % 4 == 3 ? 0xD : 0xA);
+        q.addBindValue(10000 + n % 300);
+        q.addBindValue(n);
+        q.addBindValue(n * 7);
+        q.addBindValue(n % 130);
+        q.addBindValue(n % 3);
+        q.addBindValue(n % 12);
+        q.addBindValue(n % 5);
+        q.addBindValue(QStringLiteral("BIN"));
+        if (!q.exec())
+            return false;
+    }
+    return db.commit();
+}
+
+// Best of 'rounds' runs, in rows per second; 'mapRows' appends every row
+template <typename MapRows>
+qint64 bestRate(QSqlDatabase &db, int rows, int rounds, MapRows mapRows)
+{
+    qint64 best = -1;
+
+    for (int r = 0; r < rounds; ++r) {
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        q.prepare("SELECT * FROM loco_movement_logs ORDER BY event_time DESC LIMIT ?");
+        q.addBindValue(rows);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        if (!q.exec())
+            return -1;
+
+        QJsonArray out;
+        mapRows(q, out);
+
+        const qint64 ns = timer.nsecsElapsed();
+        if (out.size() != rows)
+            return -1;
+        if (best < 0 || ns < best)
+            best = ns;
+    }
+
+    return best > 0 ? qint64(double(rows) * 1e9 / best) : -1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int rows = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    QTextStream out(stdout);
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench");
+    db.setDatabaseName(":memory:");
+    if (!db.open() || !fill(db, rows)) {
+        out << "setup failed: " << db.lastError().text() << "\n";
+        return 1;
+    }
+
+    const qint64 byName = bestRate(db, rows, rounds, [](QSqlQuery &q, QJsonArray &rowsOut) {
+        while (q.next()) {
+            const QSqlRecord rec = q.record();
+            QJsonObject row;
+            for (int i = 0; i < rec.count(); ++i) {
+                const QString name = rec.fieldName(i);
+                row[name] = q.value(name).toString();
+            }
+            rowsOut.append(row);
+        }
+    });
+
+    const qint64 mapped = bestRate(db, rows, rounds, [](QSqlQuery &q, QJsonArray &rowsOut) {
+        const SqlRowMapper mapper(q.record());
+        while (q.next())
+            rowsOut.append(mapper.map(q));
+    });
+
+    if (byName < 0 || mapped < 0) {
+        out << "query failed\n";
+        return 1;
+    }
+
+    out << "rows:         " << rows << " x " << rounds << " rounds (QSQLITE, :memory:)\n"
+        << "record+name:  " << byName << " rows/s\n"
+        << "mapper:       " << mapped << " rows/s\n"
+        << "speedup:      " << double(mapped) / byName << "x\n";
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+QT += core sql
+QT -= gui
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+
+TARGET = sql_row_mapper_bench
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    main.cpp \
+    ../../sql_row_mapper.cpp
+
+HEADERS += \
+    ../../sql_row_mapper.h
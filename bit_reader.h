@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <cstring>
+#include <stdexcept>
+
+/*
+ * MSB-first bit reader over a raw byte buffer.
+ *
+ * Fields are extracted with one unaligned 64-bit big-endian load and two
+ * shifts, so no bit strings or temporaries are ever built. Reads are
+ * bounds checked against the buffer length.
+ */
+
+class BitReader
+{
+public:
+    BitReader(const quint8* data, int lengthBytes)
+        : m_data(data),
+          m_bitLength(lengthBytes > 0 ? qint64(lengthBytes) * 8 : 0) {}
+
+    // Read 'bits' (0..32) bits and advance. Throws when past the end.
+    quint32 read(int bits)
+    {
+        if (bits < 0 || bits > 32 || m_pos + bits > m_bitLength)
+            throw std::runtime_error("BitReader out of bounds");
+
+        quint32 v = quint32(extract(m_data, m_bitLength >> 3, m_pos, bits));
+        m_pos += bits;
+        return v;
+    }
+
+    // Read a two's complement field of 'bits' bits.
+    qint32 readSigned(int bits)
+    {
+        quint32 v = read(bits);
+        if (bits > 0 && bits < 32 && (v & (1u << (bits - 1))))
+            v |= ~0u << bits;
+        return qint32(v);
+    }
+
+    void skip(int bits)
+    {
+        if (bits < 0 || m_pos + bits > m_bitLength)
+            throw std::runtime_error("BitReader skip out of bounds");
+        m_pos += bits;
+    }
+
+    void seek(qint64 bitPos) { m_pos = bitPos; }
+
+    qint64 position() const { return m_pos; }
+    qint64 bitLength() const { return m_bitLength; }
+    qint64 bitsLeft() const { return m_bitLength - m_pos; }
+
+    const quint8* data() const { return m_data; }
+
+    // ---- random access ----
+    // Extract 'bits' (0..57) bits starting at 'bitPos'. Bits past the end
+    // of the buffer read as zero, so callers that want strict bounds must
+    // check them first (read() does).
+    static quint64 extract(const quint8* d, qint64 lengthBytes,
+                           qint64 bitPos, int bits)
+    {
+        if (bits <= 0)
+            return 0;
+
+        const quint64 word = load64(d, lengthBytes, bitPos >> 3);
+        return (word << (bitPos & 7)) >> (64 - bits);
+    }
+
+private:
+    // Big-endian 64-bit load at 'bytePos', zero padded past the end.
+    static quint64 load64(const quint8* d, qint64 lengthBytes, qint64 bytePos)
+    {
+        if (bytePos < 0 || bytePos >= lengthBytes)
+            return 0;
+
+        if (bytePos + 8 <= lengthBytes)
+            return qFromBigEndian<quint64>(d + bytePos);
+
+        quint8 tail[8] = {};
+        std::memcpy(tail, d + bytePos, size_t(lengthBytes - bytePos));
+        return qFromBigEndian<quint64>(tail);
+    }
+
+    const quint8* m_data = nullptr;
+    qint64 m_bitLength = 0;
+    qint64 m_pos = 0;
+};
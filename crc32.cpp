@@ -0,0 +1,247 @@
+#include "crc32.h"
+
+#include <QtEndian>
+#include <array>
+
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#  define RGS_CRC32_PCLMUL 1
+#  include <immintrin.h>
+#endif
+
+// =====================================================
+// SLICE-BY-8 TABLES (built at compile time)
+// =====================================================
+
+using CrcTables = std::array<std::array<quint32, 256>, 8>;
+
+static constexpr CrcTables makeMsbFirstTables()
+{
+    CrcTables t{};
+
+    for (quint32 n = 0; n < 256; ++n) {
+        quint32 crc = n << 24;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+        t[0][n] = crc;
+    }
+
+    for (int k = 1; k < 8; ++k)
+        for (quint32 n = 0; n < 256; ++n)
+            t[k][n] = (t[k - 1][n] << 8) ^ t[0][t[k - 1][n] >> 24];
+
+    return t;
+}
+
+static constexpr CrcTables makeReflectedTables()
+{
+    CrcTables t{};
+
+    for (quint32 n = 0; n < 256; ++n) {
+        quint32 crc = n;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        t[0][n] = crc;
+    }
+
+    for (int k = 1; k < 8; ++k)
+        for (quint32 n = 0; n < 256; ++n)
+            t[k][n] = (t[k - 1][n] >> 8) ^ t[0][t[k - 1][n] & 0xFF];
+
+    return t;
+}
+
+static constexpr CrcTables MSB_TABLES = makeMsbFirstTables();
+static constexpr CrcTables REFLECTED_TABLES = makeReflectedTables();
+
+// =====================================================
+// MSB-FIRST (0x04C11DB7)
+// =====================================================
+
+quint32 Crc32::msbFirst(const quint8* p, qsizetype length)
+{
+    const auto& t = MSB_TABLES;
+    quint32 crc = 0xFFFFFFFF;
+
+    while (length >= 8) {
+        quint32 lo = crc ^ qFromBigEndian<quint32>(p);
+        quint32 hi = qFromBigEndian<quint32>(p + 4);
+
+        crc = t[7][lo >> 24] ^ t[6][(lo >> 16) & 0xFF] ^
+              t[5][(lo >> 8) & 0xFF] ^ t[4][lo & 0xFF] ^
+              t[3][hi >> 24] ^ t[2][(hi >> 16) & 0xFF] ^
+              t[1][(hi >> 8) & 0xFF] ^ t[0][hi & 0xFF];
+
+        p += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0)
+        crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p++];
+
+    return crc;
+}
+
+// =====================================================
+// REFLECTED (0xEDB88320)
+// =====================================================
+
+// Works on the inverted running value; callers apply init/final XOR.
+static quint32 reflectedSlice8(quint32 crc, const quint8* p, qsizetype length)
+{
+    const auto& t = REFLECTED_TABLES;
+
+    while (length >= 8) {
+        quint32 lo = crc ^ qFromLittleEndian<quint32>(p);
+        quint32 hi = qFromLittleEndian<quint32>(p + 4);
+
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+
+        p += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+
+    return crc;
+}
+
+#ifdef RGS_CRC32_PCLMUL
+
+// Carry-less multiply folding (Intel "Fast CRC Computation Using
+// PCLMULQDQ"). Needs length >= 64 and a multiple of 16.
+__attribute__((target("pclmul,sse4.1")))
+static quint32 reflectedPclmul(quint32 crc, const quint8* buf, qsizetype len)
+{
+    alignas(16) static const quint64 k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    alignas(16) static const quint64 k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    alignas(16) static const quint64 k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    alignas(16) static const quint64 poly[] = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(int(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+
+    buf += 64;
+    len -= 64;
+
+    // Fold 4 x 128 bits in parallel
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold into 128 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Remaining 16-byte blocks
+    while (len >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        buf += 16;
+        len -= 16;
+    }
+
+    // Fold 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return quint32(_mm_extract_epi32(x1, 1));
+}
+
+static bool detectPclmul()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+}
+
+#endif // RGS_CRC32_PCLMUL
+
+bool Crc32::hasPclmul()
+{
+#ifdef RGS_CRC32_PCLMUL
+    static const bool supported = detectPclmul();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+quint32 Crc32::reflected(const quint8* p, qsizetype length)
+{
+    quint32 crc = 0xFFFFFFFF;
+
+#ifdef RGS_CRC32_PCLMUL
+    if (length >= 64 && hasPclmul()) {
+        const qsizetype chunk = length & ~qsizetype(15);
+        crc = reflectedPclmul(crc, p, chunk);
+        p += chunk;
+        length -= chunk;
+    }
+#endif
+
+    return reflectedSlice8(crc, p, length) ^ 0xFFFFFFFF;
+}
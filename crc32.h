@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QtGlobal>
+
+/*
+ * Shared CRC-32 engine.
+ *
+ * Two variants:
+ *   - msbFirst():  polynomial 0x04C11DB7, MSB-first, init 0xFFFFFFFF,
+ *                  no final XOR (0x19 fault frames, LVKFaultParser::crcOk;
+ *                  checked by the fault report and by LogIngest)
+ *   - reflected(): polynomial 0xEDB88320 (reflected), init and final
+ *                  XOR 0xFFFFFFFF (cursor checksums)
+ *
+ * Both use slice-by-8 tables. The reflected variant additionally folds
+ * long buffers with PCLMULQDQ when the CPU supports it (checked once at
+ * runtime).
+ */
+
+class Crc32
+{
+public:
+    static quint32 msbFirst(const quint8* data, qsizetype length);
+    static quint32 reflected(const quint8* data, qsizetype length);
+
+    // True when the carry-less multiply path is used for reflected().
+    static bool hasPclmul();
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QString>
+#include <functional>
+
+#include "log_scanner.h"
+
+/*
+ * LRU of values built from one day file each, shared by the stores
+ * behind the reports (LocoSeriesStore, RelayStateStore, DaySummaryCache).
+ *
+ * A value is built by one LogScanner pass: fill() registers consumers
+ * that write into it. Entries are keyed by absolute hex path and
+ * invalidated by size + mtime of the file actually read (see
+ * LogScanner::daySource). T provides memoryCost() (the budget is in the
+ * same unit) and squeeze(), called once a value is complete.
+ *
+ * A followed day (today's, LogScanner::follow) is not rebuilt when it
+ * grows. Its entry also keeps the value over the day's stable frames;
+ * a copy of that is extended by the frames appended since, and the
+ * frames still being written are added to a second copy that is handed
+ * out. T is copied for this; its containers share their storage until
+ * they are appended to.
+ */
+
+template <typename T>
+class DayCache
+{
+public:
+    using Fill = std::function<void(LogScanner&, T&)>;
+
+    explicit DayCache(qint64 budget) : m_budget(budget) {}
+
+    // Value of one day file (hex path); null when it cannot be read
+    QSharedPointer<const T> day(const QString& path, const Fill& fill)
+    {
+        QFileInfo src;
+        bool binary;
+        if (!LogScanner::daySource(path, src, binary))
+            return {};
+
+        const QString key = QFileInfo(path).absoluteFilePath();
+        Entry prev;
+
+        {
+            QMutexLocker lock(&m_mutex);
+            auto it = m_days.constFind(key);
+            if (it != m_days.constEnd()) {
+                const Entry& e = it.value();
+                if (e.fileSize == src.size() && e.modified == src.lastModified()) {
+                    m_order.removeOne(key);
+                    m_order.append(key);
+                    return e.value;
+                }
+
+                prev = e;
+                m_bytes -= e.value->memoryCost();
+                m_days.erase(it);
+                m_order.removeOne(key);
+            }
+        }
+
+        // Build outside the lock
+        Entry e;
+        if (!binary && LogScanner::isFollowed(path)) {
+            if (!extend(path, fill, prev, e))
+                return {};
+        } else {
+            QSharedPointer<T> value(new T);
+            LogScanner scanner;
+            fill(scanner, *value);
+            if (!scanner.scanFile(path))
+                return {};
+            value->squeeze();
+
+            e.value = value;
+            e.fileSize = src.size();
+            e.modified = src.lastModified();
+        }
+
+        const QSharedPointer<const T> value = e.value;
+
+        QMutexLocker lock(&m_mutex);
+        if (!m_days.contains(key)) {
+            m_days.insert(key, e);
+            m_order.append(key);
+            m_bytes += value->memoryCost();
+            evict(key);
+        }
+        return value;
+    }
+
+    void setBudget(qint64 budget)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_budget = budget;
+        evict(QString());
+    }
+
+private:
+    struct Entry
+    {
+        QSharedPointer<const T> value;
+        qint64 fileSize = 0;
+        QDateTime modified;
+
+        // Followed days: value over frames [0, stableFrames) of the
+        // LogDay generation it was built from
+        QSharedPointer<const T> stable;
+        quint64 generation = 0;
+        qint32 stableFrames = 0;
+    };
+
+    // Followed day: add the frames since 'prev' to its stable value
+    // (from scratch when the day was re-read), then the unstable tail
+    static bool extend(const QString& path, const Fill& fill, const Entry& prev, Entry& e)
+    {
+        QSharedPointer<const LogDay> log = LogScanner::loadDay(path);
+        if (!log || log->binary)
+            return false;
+
+        qint32 from = 0;
+        QSharedPointer<T> stable;
+        if (prev.stable && prev.generation == log->generation &&
+            prev.stableFrames <= log->stableFrames) {
+            stable.reset(new T(*prev.stable));
+            from = prev.stableFrames;
+        } else {
+            stable.reset(new T);
+        }
+
+        LogScanner scanner;
+        fill(scanner, *stable);
+        scanner.scanFrames(*log, from, log->stableFrames);
+
+        QSharedPointer<T> value(new T(*stable));
+        LogScanner tail;
+        fill(tail, *value);
+        tail.scanFrames(*log, log->stableFrames, qint32(log->frames.size()));
+
+        e.value = value;
+        e.stable = stable;
+        e.generation = log->generation;
+        e.stableFrames = log->stableFrames;
+        e.fileSize = log->fileSize;
+        e.modified = log->modified;
+        return true;
+    }
+
+    // Caller holds the mutex
+    void evict(const QString& keep)
+    {
+        for (int i = 0; i < m_order.size() && m_bytes > m_budget; ) {
+            const QString path = m_order.at(i);
+            if (path == keep) {
+                ++i;
+                continue;
+            }
+
+            m_bytes -= m_days.value(path).value->memoryCost();
+            m_days.remove(path);
+            m_order.removeAt(i);
+        }
+    }
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_days;
+    QList<QString> m_order; // least recently used first
+    qint64 m_bytes = 0;
+    qint64 m_budget;
+};
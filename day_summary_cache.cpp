@@ -0,0 +1,95 @@
+#include "day_summary_cache.h"
+#include "day_cache.h"
+#include "graph_backend.h"
+#include "kavach_schema.h"
+#include "track_profile_graph_backend.h"
+
+qint64 DaySummary::memoryCost() const
+{
+    // Set entries at about two words each
+    return qint64(sizeof(DaySummary)) +
+           (locos.size() + stations.size() + directions.size() + profiles.size()) * 16;
+}
+
+void DaySummary::squeeze()
+{
+    locos.squeeze();
+    stations.squeeze();
+    directions.squeeze();
+    profiles.squeeze();
+}
+
+// =====================================================
+// CACHE
+// =====================================================
+
+static DayCache<DaySummary> &summaryCache()
+{
+    static DayCache<DaySummary> cache(qint64(16) << 20);
+    return cache;
+}
+
+void DaySummaryCache::setCacheBudget(qint64 bytes)
+{
+    summaryCache().setBudget(bytes);
+}
+
+// =====================================================
+// BUILD
+// =====================================================
+
+static void summarize(LogScanner &scanner, DaySummary &sum)
+{
+    // ================= AAAA12 =================
+    scanner.on(0x12, [&sum](const LogPacket &pkt)
+    {
+        quint32 loco, loc, frame;
+        quint16 speed;
+        quint8 dirVal, mode;
+
+        if (!GraphBackend::decodeLocoPacket(QByteArrayView(pkt.data, pkt.length),
+                                            loco, loc, speed, mode, dirVal, frame))
+            return;
+
+        sum.locoPackets++;
+
+        if (loc == 0 && speed == 0 && mode == 0)
+            return;
+
+        if (!sum.hasGraphLoco) {
+            sum.firstGraphLoco = loco;
+            sum.hasGraphLoco = true;
+        }
+
+        if (dirVal == 1 || dirVal == 2)
+            sum.graphDirections |= quint8(1u << dirVal);
+    });
+
+    // ================= AAAA11 =================
+    scanner.on(0x11, [&sum](const LogPacket &pkt)
+    {
+        const quint8 *p;
+        qint64 n;
+        if (!TrackProfileGraphBackend::regularPayload(pkt, p, n))
+            return;
+
+        sum.regularPackets++;
+
+        const qint64 dir = KavachSchema::project(p, n, KavachSchema::REGULAR_PKT_DIRECTION);
+
+        sum.locos.insert(quint32(
+            KavachSchema::project(p, n, KavachSchema::REGULAR_DEST_LOCO_ID)));
+        sum.profiles.insert(quint32(
+            KavachSchema::project(p, n, KavachSchema::REGULAR_REF_PROFILE_ID)));
+        sum.directions.insert((dir == 1 || dir == 2) ? quint8(dir) : quint8(0));
+
+        // Stationary kavach id, header bytes 7..8
+        if (pkt.length >= 9)
+            sum.stations.insert((pkt.data[7] << 8) | pkt.data[8]);
+    });
+}
+
+QSharedPointer<const DaySummary> DaySummaryCache::day(const QString &path)
+{
+    return summaryCache().day(path, summarize);
+}
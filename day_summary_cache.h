@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QtGlobal>
+
+/*
+ * Small per-day summaries behind the meta endpoints (/api/graph/meta,
+ * /api/track-profile/meta).
+ *
+ * One pass over a day file collects the AAAA12 graph meta (first loco
+ * with a graph value, directions) and the AAAA11 regular packet keys
+ * (loco, station, direction, profile), plus packet counts. Summaries are
+ * kept in a DayCache (day_cache.h), so a meta request over closed days
+ * only merges cached sets.
+ */
+
+struct DaySummary
+{
+    // ---- AAAA12 loco regular packets (graph meta) ----
+    quint32 locoPackets = 0;       // decoded 1010 packets
+    bool hasGraphLoco = false;
+    quint32 firstGraphLoco = 0;    // desktop rule: first with a graph value
+    quint8 graphDirections = 0;    // bit 1 nominal, bit 2 reverse
+
+    // ---- AAAA11 stationary regular packets (track profile meta) ----
+    quint32 regularPackets = 0;    // 1001 packets
+    QSet<quint32> locos;
+    QSet<int> stations;            // raw station id (bytes 7..8)
+    QSet<quint8> directions;       // 1 nominal, 2 reverse, 0 other
+    QSet<quint32> profiles;
+
+    qint64 memoryCost() const;
+    void squeeze();
+};
+
+class DaySummaryCache
+{
+public:
+    // Summary of one day file (hex path); null when it cannot be read.
+    static QSharedPointer<const DaySummary> day(const QString &path);
+
+    // Upper bound for cached summaries (bytes)
+    static void setCacheBudget(qint64 bytes);
+};
@@ -0,0 +1,369 @@
+#include "db_pool.h"
+#include "dbconfig.h"
+
+#include <QAtomicInteger>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThreadStorage>
+#include <QWaitCondition>
+#include <QtGlobal>
+
+#define JNUM(x) QJsonValue(static_cast<qint64>(x))
+
+// =====================================================
+// POOL STATE
+// =====================================================
+
+struct DbPoolState
+{
+    QMutex mutex;
+    QWaitCondition freed;
+
+    int minIdle = -1;      // default: maxLeased
+    int maxLeased = 8;
+    int waitMs = 5000;
+
+    int connections = 0;   // registered (one per thread that used the DB)
+    int open = 0;
+    int idle = 0;          // open and not leased
+    int leased = 0;
+
+    qint64 logins = 0;     // connections opened
+    qint64 reused = 0;     // leases served by an already open connection
+    qint64 closedIdle = 0;
+    qint64 healthChecks = 0;
+    qint64 healthFailures = 0;
+    qint64 waits = 0;
+    qint64 timeouts = 0;
+    qint64 openFailures = 0;
+    qint64 prepared = 0;       // statements prepared into the caches
+    qint64 statementHits = 0;  // prepare() served from a cache
+
+    DbPoolState()
+    {
+        const int mn = qEnvironmentVariableIntValue("DB_POOL_MIN");
+        const int mx = qEnvironmentVariableIntValue("DB_POOL_MAX");
+        const int w  = qEnvironmentVariableIntValue("DB_POOL_WAIT_MS");
+
+        if (mx > 0) maxLeased = mx;
+        if (mn >= 0 && qEnvironmentVariableIsSet("DB_POOL_MIN")) minIdle = mn;
+        if (w > 0) waitMs = w;
+
+        // Connections belong to threads and requests move between
+        // them, so keep every worker's connection open by default
+        if (minIdle < 0) minIdle = maxLeased;
+    }
+};
+
+static DbPoolState& poolState()
+{
+    static DbPoolState s;
+    return s;
+}
+
+static qint64 nowMs()
+{
+    static QElapsedTimer clock = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return clock.elapsed();
+}
+
+// =====================================================
+// PER-THREAD CONNECTION
+// =====================================================
+
+struct DbThreadConnection
+{
+    QString name;
+    int leases = 0;
+    bool open = false;
+    qint64 lastUsed = 0;
+
+    // Prepared on this connection; cleared before it closes
+    QHash<QString, DbConnection::Statement> statements;
+    QList<QString> statementOrder;   // least recently used first
+
+    void clearStatements()
+    {
+        statements.clear();
+        statementOrder.clear();
+    }
+
+    DbThreadConnection()
+    {
+        static QAtomicInteger<quint32> seq;
+        name = QStringLiteral("rgs_db_%1").arg(seq.fetchAndAddRelaxed(1));
+
+        QSqlDatabase db = QSqlDatabase::addDatabase("QODBC", name);
+        db.setDatabaseName(DB_CONNECTION_STRING);
+
+        DbPoolState& s = poolState();
+        QMutexLocker lock(&s.mutex);
+        s.connections++;
+    }
+
+    // Thread exit
+    ~DbThreadConnection()
+    {
+        clearStatements();
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            if (db.isOpen())
+                db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+
+        DbPoolState& s = poolState();
+        QMutexLocker lock(&s.mutex);
+        s.connections--;
+        if (open) {
+            s.open--;
+            s.idle--;
+        }
+    }
+};
+
+static DbThreadConnection* threadConnection()
+{
+    poolState();   // constructed first so it outlives the storage
+
+    static QThreadStorage<DbThreadConnection*> local;
+    if (!local.hasLocalData())
+        local.setLocalData(new DbThreadConnection);
+    return local.localData();
+}
+
+// =====================================================
+// LEASE
+// =====================================================
+
+DbConnection::DbConnection()
+{
+    DbThreadConnection* c = threadConnection();
+
+    // Nested: the outer lease already holds the slot
+    if (c->leases > 0) {
+        c->leases++;
+        m_leased = true;
+        m_valid = c->open;
+        if (!m_valid)
+            m_error = "Database not open";
+        return;
+    }
+
+    DbPoolState& s = poolState();
+    {
+        QMutexLocker lock(&s.mutex);
+
+        if (s.leased >= s.maxLeased) {
+            s.waits++;
+            QDeadlineTimer deadline(s.waitMs);
+            while (s.leased >= s.maxLeased) {
+                if (!s.freed.wait(&s.mutex, deadline)) {
+                    s.timeouts++;
+                    m_error = "Database pool exhausted";
+                    return;
+                }
+            }
+        }
+        s.leased++;
+    }
+
+    c->leases = 1;
+    m_leased = true;
+
+    QSqlDatabase db = QSqlDatabase::database(c->name, false);
+
+    if (c->open) {
+        QMutexLocker lock(&s.mutex);
+        s.idle--;
+    }
+
+    // Ping a connection that sat idle; the server may have dropped it
+    if (c->open && nowMs() - c->lastUsed > DbPool::HEALTH_CHECK_MS) {
+        bool alive;
+        {
+            QSqlQuery ping(db);
+            alive = ping.exec("SELECT 1");
+        }
+
+        QMutexLocker lock(&s.mutex);
+        s.healthChecks++;
+        if (!alive) {
+            s.healthFailures++;
+            s.open--;
+            c->open = false;
+            lock.unlock();
+            c->clearStatements();
+            db.close();
+        }
+    }
+
+    if (c->open) {
+        QMutexLocker lock(&s.mutex);
+        s.reused++;
+    } else if (db.open()) {
+        c->open = true;
+        QMutexLocker lock(&s.mutex);
+        s.open++;
+        s.logins++;
+    } else {
+        m_error = db.lastError().text();
+        QMutexLocker lock(&s.mutex);
+        s.openFailures++;
+    }
+
+    m_valid = c->open;
+}
+
+DbConnection::~DbConnection()
+{
+    if (!m_leased)
+        return;
+
+    DbThreadConnection* c = threadConnection();
+    if (--c->leases > 0)
+        return;
+
+    c->lastUsed = nowMs();
+
+    DbPoolState& s = poolState();
+    bool closeIt = false;
+    {
+        QMutexLocker lock(&s.mutex);
+        s.leased--;
+
+        // Keep at most minIdle connections open between requests
+        if (c->open) {
+            if (s.idle < s.minIdle) {
+                s.idle++;
+            } else {
+                closeIt = true;
+                c->open = false;
+                s.open--;
+                s.closedIdle++;
+            }
+        }
+    }
+    s.freed.wakeOne();
+
+    if (closeIt) {
+        c->clearStatements();
+        QSqlDatabase::database(c->name, false).close();
+    }
+}
+
+void DbConnection::discard()
+{
+    if (!m_valid)
+        return;
+
+    m_valid = false;
+    m_error = "Database connection discarded";
+
+    DbThreadConnection* c = threadConnection();
+    if (!c->open)
+        return;
+
+    {
+        DbPoolState& s = poolState();
+        QMutexLocker lock(&s.mutex);
+        s.open--;
+        c->open = false;
+    }
+
+    c->clearStatements();
+    QSqlDatabase::database(c->name, false).close();
+}
+
+QSqlDatabase DbConnection::database() const
+{
+    return QSqlDatabase::database(threadConnection()->name, false);
+}
+
+DbConnection::Statement DbConnection::prepare(const QString &sql, QSqlError &error) const
+{
+    if (!m_valid) {
+        error = QSqlError(m_error, QString(), QSqlError::ConnectionError);
+        return nullptr;
+    }
+
+    DbThreadConnection* c = threadConnection();
+    DbPoolState& s = poolState();
+
+    auto it = c->statements.constFind(sql);
+    const bool cached = it != c->statements.constEnd();
+
+    // Reused unless an outer caller still holds it and its result set
+    if (cached && it.value().use_count() == 1) {
+        c->statementOrder.removeOne(sql);
+        c->statementOrder.append(sql);
+
+        QMutexLocker lock(&s.mutex);
+        s.statementHits++;
+        return it.value();
+    }
+
+    Statement q = std::make_shared<QSqlQuery>(database());
+    q->setForwardOnly(true);
+    if (!q->prepare(sql)) {
+        error = q->lastError();
+        return nullptr;
+    }
+
+    {
+        QMutexLocker lock(&s.mutex);
+        s.prepared++;
+    }
+
+    // Uncached while the cached one is busy
+    if (cached)
+        return q;
+
+    // Evicted handles stay valid for whoever still holds them
+    if (c->statements.size() >= DbPool::MAX_STATEMENTS)
+        c->statements.remove(c->statementOrder.takeFirst());
+
+    c->statements.insert(sql, q);
+    c->statementOrder.append(sql);
+    return q;
+}
+
+// =====================================================
+// STATS
+// =====================================================
+
+QJsonObject DbPool::stats()
+{
+    DbPoolState& s = poolState();
+    QMutexLocker lock(&s.mutex);
+
+    return {
+        {"minIdle", s.minIdle},
+        {"maxLeased", s.maxLeased},
+        {"waitMs", s.waitMs},
+        {"connections", s.connections},
+        {"open", s.open},
+        {"leased", s.leased},
+        {"idle", s.idle},
+        {"logins", JNUM(s.logins)},
+        {"reused", JNUM(s.reused)},
+        {"closedIdle", JNUM(s.closedIdle)},
+        {"healthChecks", JNUM(s.healthChecks)},
+        {"healthFailures", JNUM(s.healthFailures)},
+        {"openFailures", JNUM(s.openFailures)},
+        {"prepared", JNUM(s.prepared)},
+        {"statementHits", JNUM(s.statementHits)},
+        {"waits", JNUM(s.waits)},
+        {"timeouts", JNUM(s.timeouts)}
+    };
+}
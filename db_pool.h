@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QString>
+#include <memory>
+
+/*
+ * SQL Server connections for the DB-backed backends.
+ *
+ * A QSqlDatabase may only be used by the thread that created it, so
+ * every thread gets its own named connection, opened on first use and
+ * removed when the thread exits. A DbConnection leases the calling
+ * thread's connection for one request:
+ *
+ *     DbConnection conn;
+ *     if (!conn.isValid())
+ *         return {{"success", false}, {"error", conn.error()}};
+ *     QSqlQuery q(conn.database());
+ *
+ * At most DB_POOL_MAX leases are held at once; further requests wait up
+ * to DB_POOL_WAIT_MS and then fail. When a lease ends its connection
+ * stays open (and skips the ODBC login next time) while no more than
+ * DB_POOL_MIN connections are idle; otherwise it is closed. DB_POOL_MIN
+ * defaults to DB_POOL_MAX: requests move between pool threads, so a
+ * lower count would close most connections after one use. The worker
+ * pools never expire their threads for the same reason. A connection
+ * idle for longer than HEALTH_CHECK_MS is pinged before it is handed
+ * out and reopened if the server dropped it.
+ *
+ * Nested leases on one thread share the outer one.
+ *
+ * prepare() hands out forward-only queries kept prepared on the thread's
+ * connection, keyed by their SQL text, so a statement that runs on every
+ * request is parsed and planned once per connection rather than per
+ * call. Handles are shared: one stays valid when the cache evicts its
+ * statement (least recently used first, beyond MAX_STATEMENTS), and a
+ * statement still held by an outer caller is not handed out again; a
+ * nested lease asking for the same SQL gets a query of its own. The
+ * cache is dropped whenever the connection is closed.
+ */
+
+class DbConnection
+{
+public:
+    DbConnection();
+    ~DbConnection();
+
+    DbConnection(const DbConnection &) = delete;
+    DbConnection &operator=(const DbConnection &) = delete;
+
+    // Leased and open
+    bool isValid() const { return m_valid; }
+    QString error() const { return m_error; }
+
+    QSqlDatabase database() const;
+
+    using Statement = std::shared_ptr<QSqlQuery>;
+
+    // Cached prepared query for 'sql' (bind, exec, read, then finish());
+    // null with 'error' set when it does not prepare
+    Statement prepare(const QString &sql, QSqlError &error) const;
+
+    // The server dropped the connection: close it and its statements.
+    // The lease is no longer valid; the next one on this thread logs in
+    // again.
+    void discard();
+
+private:
+    bool m_leased = false;
+    bool m_valid = false;
+    QString m_error;
+};
+
+class DbPool
+{
+public:
+    static constexpr qint64 HEALTH_CHECK_MS = 30 * 1000;
+
+    // Prepared statements kept per connection; beyond it the least
+    // recently used one is dropped
+    static constexpr int MAX_STATEMENTS = 64;
+
+    // Sizes, open / idle / leased connections, logins, waits and
+    // prepared statement reuse
+    static QJsonObject stats();
+};
@@ -3,8 +3,7 @@
 
 #include <QString>
 
-// Connection name
-static const QString DB_CONN_NAME = "main_db_conn";
+// Connections are named per thread by DbPool (db_pool.h)
 
 // SQL Server connection string
 static const QString DB_CONNECTION_STRING =
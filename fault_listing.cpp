@@ -0,0 +1,267 @@
+#include "fault_listing.h"
+#include "crc32.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QtDebug>
+
+static const char *const COLUMNS =
+    "id, event_time, loco_id, station_code, fault_code, description, status";
+
+static const char *const ORDER = "ORDER BY event_time DESC, id DESC";
+
+// =====================================================
+// CURSOR
+// =====================================================
+
+// Last row of a page; 'query' ties it to the table and station filter
+struct FaultCursor
+{
+    QDateTime eventTime;
+    qint64 id = 0;
+    quint32 query = 0;
+};
+
+static quint32 queryKey(const QString &table, const QString &station)
+{
+    const QByteArray key = (table + '\n' + station).toUtf8();
+    return Crc32::reflected(reinterpret_cast<const quint8 *>(key.constData()),
+                            key.size());
+}
+
+static QString encodeCursor(const FaultCursor &c)
+{
+    const QString text = QStringList{
+        c.eventTime.toString(Qt::ISODateWithMs),
+        QString::number(c.id), QString::number(c.query)
+    }.join('|');
+
+    return QString::fromLatin1(text.toUtf8().toBase64(
+        QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+}
+
+static bool decodeCursor(const QString &text, FaultCursor &c)
+{
+    const auto decoded = QByteArray::fromBase64Encoding(
+        text.toLatin1(),
+        QByteArray::Base64UrlEncoding | QByteArray::AbortOnBase64DecodingErrors);
+    if (!decoded)
+        return false;
+
+    const QStringList p = QString::fromUtf8(*decoded).split('|');
+    if (p.size() != 3)
+        return false;
+
+    bool ok[2];
+    c.eventTime = QDateTime::fromString(p[0], Qt::ISODateWithMs);
+    c.id        = p[1].toLongLong(&ok[0]);
+    c.query     = p[2].toUInt(&ok[1]);
+
+    return c.eventTime.isValid() && ok[0] && ok[1];
+}
+
+// =====================================================
+// ROWS
+// =====================================================
+
+// Up to 'limit' rows of 'q' (which fetched limit + 1); true when more follow
+static bool readRows(QSqlQuery &q, FaultListing::RowFn toRow, int limit,
+                     QJsonArray &rows, FaultCursor &last)
+{
+    int n = 0;
+    while (q.next()) {
+        if (n == limit)
+            return true;
+
+        rows.append(toRow(q));
+
+        last.id = q.value(0).toLongLong();
+        last.eventTime = q.value(1).toDateTime();
+        n++;
+    }
+    return false;
+}
+
+// Run a cached statement and read its page; the statement is finished
+// either way so the connection can reuse it
+static bool execRows(QSqlQuery &q, FaultListing::RowFn toRow, int limit,
+                     QJsonArray &rows, FaultCursor &last, bool &hasNext,
+                     QSqlError &error)
+{
+    const bool ok = q.exec();
+    if (ok)
+        hasNext = readRows(q, toRow, limit, rows, last);
+    else
+        error = q.lastError();
+
+    q.finish();
+    return ok;
+}
+
+QJsonObject FaultListing::fetchPage(const DbConnection &conn, const QString &table, RowFn toRow,
+                                    const QString &station, const QString &cursor,
+                                    int limit)
+{
+    limit = qBound(1, limit, MAX_LIMIT);
+
+    const quint32 query = queryKey(table, station);
+
+    FaultCursor resume;
+    const bool resuming = !cursor.isEmpty();
+    if (resuming && (!decodeCursor(cursor, resume) || resume.query != query))
+        return {{"success", false}, {"error", "Invalid cursor"}};
+
+    // One statement per shape, so each has a plain seek predicate
+    QStringList where;
+    if (!station.isEmpty())
+        where << "station_code = ?";
+    if (resuming)
+        where << "(event_time < ? OR (event_time = ? AND id < ?))";
+
+    QString sql = QString("SELECT %1 FROM %2 ").arg(COLUMNS, table);
+    if (!where.isEmpty())
+        sql += "WHERE " + where.join(" AND ") + ' ';
+    sql += QString("%1 OFFSET 0 ROWS FETCH NEXT ? ROWS ONLY").arg(ORDER);
+
+    QSqlError error;
+    DbConnection::Statement q = conn.prepare(sql, error);
+    if (!q)
+        return {{"success", false}, {"error", error.text()}};
+
+    int n = 0;
+    if (!station.isEmpty())
+        q->bindValue(n++, station);
+    if (resuming) {
+        q->bindValue(n++, resume.eventTime);
+        q->bindValue(n++, resume.eventTime);
+        q->bindValue(n++, resume.id);
+    }
+    q->bindValue(n++, limit + 1);
+
+    QJsonArray rows;
+    FaultCursor next;
+    next.query = query;
+    bool hasNext;
+
+    if (!execRows(*q, toRow, limit, rows, next, hasNext, error))
+        return {{"success", false}, {"error", error.text()}};
+
+    return {
+        {"success", true},
+        {"data", rows},
+        {"limit", limit},
+        {"nextCursor", hasNext ? encodeCursor(next) : QString()}
+    };
+}
+
+QJsonObject FaultListing::fetchOffsetPage(const DbConnection &conn, const QString &table, RowFn toRow,
+                                          const QString &station, int page, int limit)
+{
+    page = qMax(1, page);
+    limit = qBound(1, limit, MAX_LIMIT);
+
+    QString sql = QString("SELECT %1 FROM %2 ").arg(COLUMNS, table);
+    if (!station.isEmpty())
+        sql += "WHERE station_code = ? ";
+    sql += QString("%1 OFFSET ? ROWS FETCH NEXT ? ROWS ONLY").arg(ORDER);
+
+    QSqlError error;
+    DbConnection::Statement q = conn.prepare(sql, error);
+    if (!q)
+        return {{"success", false}, {"error", error.text()}};
+
+    int n = 0;
+    if (!station.isEmpty())
+        q->bindValue(n++, station);
+    q->bindValue(n++, qint64(page - 1) * limit);
+    q->bindValue(n++, limit + 1);
+
+    QJsonArray rows;
+    FaultCursor next;
+    next.query = queryKey(table, station);
+    bool hasNext;
+
+    if (!execRows(*q, toRow, limit, rows, next, hasNext, error))
+        return {{"success", false}, {"error", error.text()}};
+
+    return {
+        {"success", true},
+        {"data", rows},
+        {"page", page},
+        {"limit", limit},
+        {"nextCursor", hasNext ? encodeCursor(next) : QString()}
+    };
+}
+
+// =====================================================
+// INDEXES
+// =====================================================
+
+static QStringList indexNames(const QString &table)
+{
+    return {"ix_" + table + "_time", "ix_" + table + "_station_time"};
+}
+
+QStringList FaultListing::indexDdl(const QString &table)
+{
+    const QStringList names = indexNames(table);
+    const QString include = "INCLUDE (loco_id, fault_code, description, status)";
+
+    return {
+        QString("CREATE INDEX %1 ON %2 (event_time DESC, id DESC) %3")
+            .arg(names[0], table, include),
+        QString("CREATE INDEX %1 ON %2 (station_code, event_time DESC, id DESC) %3")
+            .arg(names[1], table, include)
+    };
+}
+
+bool FaultListing::createIndexes(QSqlDatabase &db, const QString &table, QString &error)
+{
+    for (const QString &ddl : indexDdl(table)) {
+        QSqlQuery q(db);
+        if (!q.exec(ddl)) {
+            error = q.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+void FaultListing::checkIndexes()
+{
+    DbConnection conn;
+    if (!conn.isValid()) {
+        qWarning().noquote() << "Fault listing index check skipped:" << conn.error();
+        return;
+    }
+
+    QSqlDatabase db = conn.database();
+
+    for (const QString table : {"gprs_fault_logs", "rfcom_fault_logs"}) {
+        const QStringList names = indexNames(table);
+        const QStringList ddl = indexDdl(table);
+
+        for (int i = 0; i < names.size(); ++i) {
+            QSqlQuery q(db);
+            q.prepare("SELECT COUNT(*) FROM sys.indexes "
+                      "WHERE object_id = OBJECT_ID(?) AND name = ?");
+            q.addBindValue(table);
+            q.addBindValue(names[i]);
+
+            if (!q.exec() || !q.next()) {
+                qWarning().noquote() << "Fault listing index check failed:"
+                                     << q.lastError().text();
+                return;
+            }
+
+            if (q.value(0).toInt() == 0)
+                qWarning().noquote() << "Missing index on" << table
+                                     << "- deep fault pages will scan; create it with:"
+                                     << ddl[i];
+        }
+    }
+}
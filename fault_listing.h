@@ -0,0 +1,56 @@
+#pragma once
+
+#include "db_pool.h"
+
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+
+/*
+ * Newest-first listing of gprs_fault_logs / rfcom_fault_logs.
+ *
+ * Pages seek on (event_time, id) instead of skipping OFFSET rows, so
+ * page 1000 costs the same as page 1:
+ *
+ *     WHERE event_time < :t OR (event_time = :t AND id < :id)
+ *     ORDER BY event_time DESC, id DESC
+ *
+ * The position is handed to the client as an opaque 'nextCursor' (the
+ * last row's event_time and id plus a checksum of the filter it belongs
+ * to). Filtered and unfiltered listings are separate statements, so the
+ * station predicate can use an index instead of being OR-ed away; each
+ * shape stays prepared on the connection (DbConnection::prepare()).
+ *
+ * Both shapes are served by the covering indexes of indexDdl(); they are
+ * created with the tables and checked at startup (checkIndexes()).
+ */
+
+class FaultListing
+{
+public:
+    static constexpr int MAX_LIMIT = 1000;
+
+    // JSON row of the current record; columns are id, event_time,
+    // loco_id, station_code, fault_code, description, status
+    using RowFn = QJsonObject (*)(const QSqlQuery &q);
+
+    // Page after 'cursor' (empty: first page), at most 'limit' rows
+    static QJsonObject fetchPage(const DbConnection &conn, const QString &table, RowFn toRow,
+                                 const QString &station, const QString &cursor,
+                                 int limit);
+
+    // Numbered page (OFFSET); kept for existing clients, also returns
+    // the nextCursor to continue from
+    static QJsonObject fetchOffsetPage(const DbConnection &conn, const QString &table, RowFn toRow,
+                                       const QString &station, int page, int limit);
+
+    // CREATE INDEX statements recommended for 'table'
+    static QStringList indexDdl(const QString &table);
+
+    static bool createIndexes(QSqlDatabase &db, const QString &table, QString &error);
+
+    // Log a warning with the DDL for every recommended index that is missing
+    static void checkIndexes();
+};
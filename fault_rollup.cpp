@@ -0,0 +1,278 @@
+#include "fault_rollup.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+static const char *const ROLLUP_TABLE = "fault_summary_daily";
+
+static bool isSqlite(const QSqlDatabase &db)
+{
+    return db.driverName() == "QSQLITE";
+}
+
+// =====================================================
+// DELTA
+// =====================================================
+
+void FaultRollupDelta::add(const QString &station, const QDate &day, qint64 count)
+{
+    if (station.isEmpty() || !day.isValid())
+        return;
+
+    m_counts[qMakePair(station, day)] += count;
+}
+
+// =====================================================
+// TABLE
+// =====================================================
+
+QString FaultRollup::sourceName(Source source)
+{
+    switch (source) {
+    case Loco:  return "LOCO";
+    case Gprs:  return "GPRS";
+    case Rfcom: return "RFCOM";
+    }
+    return QString();
+}
+
+bool FaultRollup::ensureTable(QSqlDatabase &db, QString &error)
+{
+    static QMutex mutex;
+    static QSet<QString> ready;   // driver|database already checked
+
+    const QString key = db.driverName() + '|' + db.databaseName();
+
+    QMutexLocker lock(&mutex);
+    if (ready.contains(key))
+        return true;
+
+    if (!db.tables().contains(ROLLUP_TABLE, Qt::CaseInsensitive)) {
+        const QString sql = QString(
+            "CREATE TABLE %1 ("
+            "station_code VARCHAR(16) NOT NULL,"
+            "fault_day DATE NOT NULL,"
+            "source VARCHAR(8) NOT NULL,"
+            "fault_count BIGINT NOT NULL,"
+            "PRIMARY KEY (station_code, fault_day, source))").arg(ROLLUP_TABLE);
+
+        if (!db.transaction()) {
+            error = db.lastError().text();
+            return false;
+        }
+
+        QSqlQuery q(db);
+        if (!q.exec(sql) || !backfill(db, error)) {
+            if (error.isEmpty())
+                error = q.lastError().text();
+            db.rollback();
+            return false;
+        }
+
+        if (!db.commit()) {
+            error = db.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+
+    ready.insert(key);
+    return true;
+}
+
+bool FaultRollup::backfill(QSqlDatabase &db, QString &error)
+{
+    const QString day = isSqlite(db) ? "date(event_time)" : "CAST(event_time AS DATE)";
+
+    const QStringList existing = db.tables();
+
+    const QPair<Source, QString> sources[] = {
+        {Loco,  "loco_fault_logs"},
+        {Gprs,  "gprs_fault_logs"},
+        {Rfcom, "rfcom_fault_logs"}
+    };
+
+    for (const auto &src : sources) {
+        // Not created yet: nothing to count
+        if (!existing.contains(src.second, Qt::CaseInsensitive))
+            continue;
+
+        QSqlQuery q(db);
+        if (!q.exec(QString(
+                "INSERT INTO %1 (station_code, fault_day, source, fault_count) "
+                "SELECT station_code, %2, '%3', COUNT(*) "
+                "FROM %4 "
+                "WHERE station_code IS NOT NULL AND station_code <> '' "
+                "GROUP BY station_code, %2")
+                .arg(ROLLUP_TABLE, day, sourceName(src.first), src.second))) {
+            error = q.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+// =====================================================
+// DELTAS
+// =====================================================
+
+// One statement per (station, day), so concurrent writers cannot both
+// insert the same row: SQL Server MERGE under HOLDLOCK keeps the key
+// range locked from the match to the insert; SQLite has one writer at a
+// time and upserts with ON CONFLICT.
+static QString upsertSql(const QSqlDatabase &db)
+{
+    if (isSqlite(db))
+        return QString(
+            "INSERT INTO %1 (station_code, fault_day, source, fault_count) "
+            "VALUES (?, ?, ?, ?) "
+            "ON CONFLICT (station_code, fault_day, source) "
+            "DO UPDATE SET fault_count = fault_count + excluded.fault_count").arg(ROLLUP_TABLE);
+
+    return QString(
+        "MERGE %1 WITH (HOLDLOCK) AS t "
+        "USING (SELECT CAST(? AS VARCHAR(16)) AS station_code, CAST(? AS DATE) AS fault_day, "
+        "CAST(? AS VARCHAR(8)) AS source, CAST(? AS BIGINT) AS fault_count) AS s "
+        "ON t.station_code = s.station_code AND t.fault_day = s.fault_day "
+        "AND t.source = s.source "
+        "WHEN MATCHED THEN UPDATE SET fault_count = t.fault_count + s.fault_count "
+        "WHEN NOT MATCHED THEN INSERT (station_code, fault_day, source, fault_count) "
+        "VALUES (s.station_code, s.fault_day, s.source, s.fault_count);").arg(ROLLUP_TABLE);
+}
+
+bool FaultRollup::apply(QSqlDatabase &db, Source source,
+                        const FaultRollupDelta &delta, QSqlError &error)
+{
+    if (delta.isEmpty())
+        return true;
+
+    QSqlQuery upsert(db);
+    if (!upsert.prepare(upsertSql(db))) {
+        error = upsert.lastError();
+        return false;
+    }
+
+    const QString name = sourceName(source);
+
+    const auto &counts = delta.counts();
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        upsert.bindValue(0, it.key().first);
+        upsert.bindValue(1, it.key().second);
+        upsert.bindValue(2, name);
+        upsert.bindValue(3, it.value());
+
+        if (!upsert.exec()) {
+            error = upsert.lastError();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FaultRollup::clear(QSqlDatabase &db, Source source, QString &error)
+{
+    if (!ensureTable(db, error))
+        return false;
+
+    QSqlQuery q(db);
+    q.prepare(QString("DELETE FROM %1 WHERE source = ?").arg(ROLLUP_TABLE));
+    q.addBindValue(sourceName(source));
+
+    if (!q.exec()) {
+        error = q.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QDate FaultRollup::dayOf(const QString &eventTime)
+{
+    QDateTime dt = QDateTime::fromString(eventTime, Qt::ISODate);
+    if (!dt.isValid())
+        dt = QDateTime::fromString(eventTime, "yyyy-MM-dd HH:mm:ss");
+    if (dt.isValid())
+        return dt.date();
+
+    return QDate::fromString(eventTime.left(10), "yyyy-MM-dd");
+}
+
+// =====================================================
+// SUMMARY
+// =====================================================
+
+QJsonObject FaultRollup::summary(QSqlDatabase &db, const QDate &from, const QDate &to)
+{
+    QString error;
+    if (!ensureTable(db, error))
+        return {{"success", false}, {"error", error}};
+
+    QString sql = QString(
+        "SELECT station_code, source, SUM(fault_count) AS cnt FROM %1").arg(ROLLUP_TABLE);
+
+    QStringList where;
+    if (from.isValid())
+        where << "fault_day >= ?";
+    if (to.isValid())
+        where << "fault_day <= ?";
+    if (!where.isEmpty())
+        sql += " WHERE " + where.join(" AND ");
+
+    sql += " GROUP BY station_code, source";
+
+    QSqlQuery q(db);
+    q.prepare(sql);
+    if (from.isValid())
+        q.addBindValue(from);
+    if (to.isValid())
+        q.addBindValue(to);
+
+    if (!q.exec())
+        return {{"success", false}, {"error", q.lastError().text()}};
+
+    QMap<QString, QJsonObject> summaryMap;
+
+    while (q.next()) {
+        const QString station = q.value(0).toString();
+        const QString source = q.value(1).toString();
+        const qint64 count = q.value(2).toLongLong();
+
+        QJsonObject &obj = summaryMap[station];
+        if (obj.isEmpty()) {
+            obj = {
+                {"station", station},
+                {"locoFaults", 0},
+                {"gprsFaults", 0},
+                {"rfcomFaults", 0},
+                {"total", 0}
+            };
+        }
+
+        const QString keyName =
+            source == sourceName(Loco) ? "locoFaults" :
+            source == sourceName(Gprs) ? "gprsFaults" : "rfcomFaults";
+
+        obj[keyName] = count;
+        obj["total"] = obj["total"].toInteger() + count;
+    }
+
+    QJsonArray result;
+    for (auto it = summaryMap.cbegin(); it != summaryMap.cend(); ++it)
+        result.append(it.value());
+
+    QJsonObject res{
+        {"success", true},
+        {"data", result}
+    };
+    if (from.isValid())
+        res["from"] = from.toString(Qt::ISODate);
+    if (to.isValid())
+        res["to"] = to.toString(Qt::ISODate);
+    return res;
+}
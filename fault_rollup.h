@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QDate>
+#include <QHash>
+#include <QJsonObject>
+#include <QPair>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QString>
+
+/*
+ * Per-station, per-day fault counts (fault_summary_daily), so the fault
+ * summary reads a few hundred rollup rows instead of grouping the fault
+ * tables on every dashboard poll.
+ *
+ * Every writer of a fault table adds its rows to the rollup in the same
+ * transaction: LogIngest for loco_fault_logs, insertFault() for
+ * gprs_fault_logs and rfcom_fault_logs. The table is created on first
+ * use and filled once from the existing fault rows; from then on only
+ * deltas are applied, each as one upsert that concurrent writers cannot
+ * race. Rows without a station code (NULL or empty) are not counted, as
+ * before.
+ */
+
+class FaultRollupDelta
+{
+public:
+    void add(const QString &station, const QDate &day, qint64 count = 1);
+
+    bool isEmpty() const { return m_counts.isEmpty(); }
+
+    const QHash<QPair<QString, QDate>, qint64> &counts() const { return m_counts; }
+
+private:
+    QHash<QPair<QString, QDate>, qint64> m_counts;   // (station, day) -> rows
+};
+
+class FaultRollup
+{
+public:
+    enum Source { Loco, Gprs, Rfcom };
+
+    static QString sourceName(Source source);
+
+    // Create (and backfill) the rollup when missing; once per process
+    // and database. Opens its own transaction, so call it before the
+    // writer's.
+    static bool ensureTable(QSqlDatabase &db, QString &error);
+
+    // Add 'delta' to the rollup; call inside the writer's transaction
+    static bool apply(QSqlDatabase &db, Source source,
+                      const FaultRollupDelta &delta, QSqlError &error);
+
+    // Drop the counts of 'source' (its fault table was recreated)
+    static bool clear(QSqlDatabase &db, Source source, QString &error);
+
+    // Day of an event_time as written by the insert routes
+    static QDate dayOf(const QString &eventTime);
+
+    // Station-wise totals over [from, to]; invalid dates leave it open
+    static QJsonObject summary(QSqlDatabase &db, const QDate &from, const QDate &to);
+
+private:
+    static bool backfill(QSqlDatabase &db, QString &error);
+};
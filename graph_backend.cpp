@@ -1,6 +1,10 @@
 #include "graph_backend.h"
+#include "bit_reader.h"
+#include "log_scanner.h"
+#include "day_summary_cache.h"
+#include "loco_series_store.h"
+#include "log_parallel.h"
 
-#include <QFile>
 #include <QDir>
 #include <QDate>
 #include <QDateTime>
@@ -8,39 +12,12 @@
 #include <QSet>
 #include <algorithm>
 #include <iostream>
-// --------------------------------------------------
-// Read raw AAAA12 packets
-// --------------------------------------------------
-QStringList GraphBackend::readBinFile(const QString &filePath)
-{
-    QFile file(filePath);
-    QStringList packets;
-
-    if (!file.open(QIODevice::ReadOnly))
-        return packets;
-
-    QByteArray raw = file.readAll().toUpper();
-    raw.replace("\r", "");
-    raw.replace("\n", "");
-
-    // split by AAAA12
-    raw.replace("AAAA12", "|AAAA12");
-    QList<QByteArray> split = raw.split('|');
-
-    for (const QByteArray &p : split)
-    {
-        if (p.startsWith("AAAA12"))
-            packets.append(QString::fromLatin1(p));
-    }
-    return packets;
-}
-
 // --------------------------------------------------
 // Decode ONE loco regular packet (AAAA12, 1010)
 // Desktop-accurate decoding
 // --------------------------------------------------
 bool GraphBackend::decodeLocoPacket(
-    const QByteArray &pktHex,
+    QByteArrayView pkt,
     quint32 &locoId,
     quint32 &absLoc,
     quint16 &speed,
@@ -49,8 +26,6 @@ bool GraphBackend::decodeLocoPacket(
     quint32 &frameNo
     )
 {
-    QByteArray pkt = QByteArray::fromHex(pktHex);
-
     if (pkt.size() < 30)
         return false;
 
@@ -76,29 +51,29 @@ bool GraphBackend::decodeLocoPacket(
     if (payloadStart + 16 >= pkt.size())
         return false;
 
-    // Convert payload to bit string (DESKTOP PARITY)
-    QString bits;
-    for (int i = payloadStart; i < pkt.size() - 4; ++i) // skip CRC
-    {
-        quint8 b = static_cast<quint8>(pkt[i]);
-        for (int k = 7; k >= 0; --k)
-            bits.append((b >> k) & 1 ? '1' : '0');
-    }
+    // Payload bits up to the CRC (DESKTOP PARITY)
+    const quint8 *payload =
+        reinterpret_cast<const quint8 *>(pkt.constData()) + payloadStart;
+    const qint64 payloadLen = pkt.size() - 4 - payloadStart;
 
-    if (bits.size() < 123)
+    if (payloadLen * 8 < 123)
         return false;
 
+    auto field = [&](int pos, int len) {
+        return quint32(BitReader::extract(payload, payloadLen, pos, len));
+    };
+
     // Decode fields (same as desktop)
-    quint8 pktType = bits.mid(0,4).toUInt(nullptr,2);
+    quint8 pktType = field(0, 4);
     if (pktType != 0x0A)
         return false;
 
-    frameNo = bits.mid(11,17).toUInt(nullptr,2);
-    locoId  = bits.mid(28,20).toUInt(nullptr,2);
-    absLoc  = bits.mid(51,23).toUInt(nullptr,2);
-    speed   = bits.mid(105,9).toUInt(nullptr,2);
-    direction = bits.mid(114,2).toUInt(nullptr,2);
-    mode      = bits.mid(119,4).toUInt(nullptr,2);
+    frameNo   = field(11, 17);
+    locoId    = field(28, 20);
+    absLoc    = field(51, 23);
+    speed     = field(105, 9);
+    direction = field(114, 2);
+    mode      = field(119, 4);
 
     if (locoId == 0 || locoId == 0xFFFFF)
         return false;
@@ -134,6 +109,7 @@ QJsonObject GraphBackend::getGraphMeta(
 
     QDir dir(logDir);
     QStringList files = dir.entryList({"*.bin"}, QDir::Files);
+    QStringList paths;
 
     for (const QString &f : files)
     {
@@ -148,43 +124,26 @@ QJsonObject GraphBackend::getGraphMeta(
             continue;
 
         dateSet.insert(fileDate.toString("yyyy-MM-dd"));
+        paths.append(logDir + "/" + f);
+    }
 
-        QStringList packets = readBinFile(logDir + "/" + f);
-
-        // REMOVED the locoCaptured flag - now captures ALL locos
-        bool locoSelectedForFile = false;
-
-        for (const QString &pkt : packets)
-        {
-            quint32 loco, absLoc, frame;
-            quint16 speed;
-            quint8 dirVal, mode;
-
-            if (!decodeLocoPacket(pkt.toLatin1(), loco, absLoc, speed, mode, dirVal, frame))
-                continue;
-
-            bool hasGraphValue =
-                (absLoc > 0) ||
-                (speed > 0)  ||
-                (mode > 0);
+    // Summaries missing from the cache are built concurrently
+    const auto summaries =
+        LogParallel::mapDays<QSharedPointer<const DaySummary>>(paths, DaySummaryCache::day);
 
-            if (!hasGraphValue)
-                continue;
+    for (const QSharedPointer<const DaySummary> &day : summaries)
+    {
+        if (!day)
+            continue;
 
-            // DESKTOP RULE: first valid loco ONLY
-            if (!locoSelectedForFile)
-            {
-                locoWithGraphData.insert(QString::number(loco));
-                locoSelectedForFile = true;
-            }
-
-            // collect directions (same as before)
-            if (dirVal == 1)
-                dirSet.insert("Nominal");
-            else if (dirVal == 2)
-                dirSet.insert("Reverse");
-        }
+        // DESKTOP RULE: first valid loco ONLY
+        if (day->hasGraphLoco)
+            locoWithGraphData.insert(QString::number(day->firstGraphLoco));
 
+        if (day->graphDirections & (1u << 1))
+            dirSet.insert("Nominal");
+        if (day->graphDirections & (1u << 2))
+            dirSet.insert("Reverse");
     }
     QStringList locos = locoWithGraphData.values();
 
@@ -216,124 +175,130 @@ QJsonObject GraphBackend::getGraphMeta(
 }
 
 
-QJsonObject GraphBackend::getGraphData(
+// Points of 'graphType' for one loco and direction, straight from the
+// day columns
+void GraphBackend::collectSeries(
     const QString &locoIdStr,
     const QString &fromDate,
     const QString &toDate,
     const QString &directionStr,
-    const QString &,
     const QString &graphType,
-    const QString &logDir
+    const QString &logDir,
+    GraphSeries &out,
+    bool &hasData
     )
 {
     quint32 targetLoco = locoIdStr.toUInt();
 
-
-
-    QJsonArray xArr, yArr;
-    bool hasData = false;
-    int totalPackets = 0;
-    int decodedPackets = 0;
-    int matchedLoco = 0;
-    int matchedDirection = 0;
+    hasData = false;
 
     QDate from = QDate::fromString(fromDate.left(10), "yyyy-MM-dd");
     QDate to   = QDate::fromString(toDate.left(10), "yyyy-MM-dd");
 
-
-
-    for (QDate d = from; d <= to; d = d.addDays(1))
+    // Direction code wanted; 0 = Unidentified (anything but 1/2)
+    quint8 wantDir = 0;
+    if (directionStr == "Nominal")
+        wantDir = 1;
+    else if (directionStr == "Reverse")
+        wantDir = 2;
+    else if (directionStr != "Unidentified")
+        wantDir = 0xFF;   // matches nothing
+
+    // Columns plotted, chosen once for the whole request
+    const bool byLocation = graphType.startsWith("Location");
+    const bool byTime     = graphType.startsWith("Time");
+    const bool ofSpeed    = graphType.endsWith("Vs Speed");
+    const bool ofMode     = graphType.endsWith("Vs Mode");
+    const bool plotted    = (byLocation || byTime) && (ofSpeed || ofMode);
+
+    // Days missing from the store are decoded concurrently
+    const auto days = LogParallel::mapDays<QSharedPointer<const LocoDaySeries>>(
+        LogParallel::dayPaths(logDir, from, to), LocoSeriesStore::day);
+
+    for (const QSharedPointer<const LocoDaySeries> &series : days)
     {
-        QString file = logDir + "/" + d.toString("dd-MM-yy") + ".bin";
-
-
-        QStringList packets = readBinFile(file);
-        totalPackets += packets.size();
+        if (!series)
+            continue;
 
+        auto it = series->locos.constFind(targetLoco);
+        if (it == series->locos.constEnd())
+            continue;
 
+        const LocoColumns &c = it.value();
+        const QVector<quint32> &xs = byLocation ? c.location : c.frame;
 
-        for (const QString &pkt : packets)
+        for (int i = 0; i < c.size(); ++i)
         {
-            quint32 loco, loc, frame;
-            quint16 speed;
-            quint8 dirVal, mode;
-
-            if (!decodeLocoPacket(pkt.toLatin1(), loco, loc, speed, mode, dirVal, frame))
+            const quint8 dirVal = c.direction.at(i);
+            const bool match = wantDir == 0 ? (dirVal != 1 && dirVal != 2)
+                                            : dirVal == wantDir;
+            if (!match)
                 continue;
 
-            decodedPackets++;
-
-            if (loco != targetLoco)
-            {
-                // std::cout << "  Skipped: Loco mismatch (" << loco
-                //           << " != " << targetLoco << ")" << std::endl;
-                continue;
-            }
-
-            matchedLoco++;
-
-            QString dir;
-            switch (dirVal)
-            {
-            case 1: dir = "Nominal"; break;
-            case 2: dir = "Reverse"; break;
-            default: dir = "Unidentified"; break;
-            }
-
-            if (dir != directionStr)
-            {
-
+            hasData = true;
+            if (!plotted)
                 continue;
-            }
-
-            matchedDirection++;
-
-            if (graphType == "Location Vs Speed")
-            {
-                xArr.append((int)loc);
-                yArr.append((int)speed);
-
-            }
-            else if (graphType == "Time Vs Speed")
-            {
-                xArr.append((int)frame);
-                yArr.append((int)speed);
 
-            }
-            else if (graphType == "Location Vs Mode")
-            {
-                xArr.append((int)loc);
-                yArr.append((int)mode);
-
-            }
-            else if (graphType == "Time Vs Mode")
-            {
-                xArr.append((int)frame);
-                yArr.append((int)mode);
-
-            }
-
-            hasData = true;
+            out.append(qint32(xs.at(i)),
+                       ofSpeed ? qint32(c.speed.at(i)) : qint32(c.mode.at(i)));
         }
     }
+}
 
-    // std::cout << "\n========== SUMMARY ==========" << std::endl;
-    // std::cout << "Total packets read: " << totalPackets << std::endl;
-    // std::cout << "Successfully decoded: " << decodedPackets << std::endl;
-    // std::cout << "Matched loco: " << matchedLoco << std::endl;
-    // std::cout << "Matched direction: " << matchedDirection << std::endl;
-    // std::cout << "Data points added: " << xArr.size() << std::endl;
-    // std::cout << "=============================" << std::endl;
+QJsonObject GraphBackend::getGraphData(
+    const QString &locoIdStr,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &directionStr,
+    const QString &,
+    const QString &graphType,
+    const QString &logDir,
+    const GraphReduction &reduce
+    )
+{
+    GraphSeries series;
+    bool hasData;
+    collectSeries(locoIdStr, fromDate, toDate, directionStr, graphType, logDir,
+                  series, hasData);
 
-    QJsonObject data;
-    data["x"] = xArr;
-    data["y"] = yArr;
+    const qsizetype totalPoints = series.size();
+    series = reduce.apply(series);
 
     QJsonObject res;
     res["success"] = true;
     res["graphType"] = graphType;
-    res["data"] = data;
+    res["data"] = GraphSeriesFormat::toJsonColumns(series);
     res["hasData"] = hasData;
+    res["totalPoints"] = qint64(totalPoints);
+
+    return res;
+}
+
+QCborMap GraphBackend::getGraphDataCbor(
+    const QString &locoIdStr,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &directionStr,
+    const QString &,
+    const QString &graphType,
+    const QString &logDir,
+    const GraphReduction &reduce
+    )
+{
+    GraphSeries series;
+    bool hasData;
+    collectSeries(locoIdStr, fromDate, toDate, directionStr, graphType, logDir,
+                  series, hasData);
+
+    const qsizetype totalPoints = series.size();
+    series = reduce.apply(series);
+
+    QCborMap res;
+    res.insert(QStringLiteral("success"), true);
+    res.insert(QStringLiteral("graphType"), graphType);
+    res.insert(QStringLiteral("data"), GraphSeriesFormat::toCbor(series));
+    res.insert(QStringLiteral("hasData"), hasData);
+    res.insert(QStringLiteral("totalPoints"), qint64(totalPoints));
 
     return res;
 }
@@ -1,10 +1,14 @@
 #ifndef GRAPH_BACKEND_H
 #define GRAPH_BACKEND_H
 
+#include <QByteArrayView>
+#include <QCborMap>
 #include <QJsonObject>
 #include <QString>
 #include <QStringList>
 
+#include "graph_series.h"
+
 class GraphBackend
 {
 public:
@@ -24,15 +28,27 @@ public:
         const QString &direction,
         const QString &profileId,
         const QString &graphType,
-        const QString &logDir
+        const QString &logDir,
+        const GraphReduction &reduce = {}   // maxPoints / downsample
         );
 
+    // Same response as CBOR, the series as int32 typed arrays
+    // (see graph_series.h)
+    static QCborMap getGraphDataCbor(
+        const QString &locoId,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &direction,
+        const QString &profileId,
+        const QString &graphType,
+        const QString &logDir,
+        const GraphReduction &reduce = {}   // maxPoints / downsample
+        );
 
-private:
-    // helpers
-    static QStringList readBinFile(const QString &filePath);
+    // Decode ONE loco regular packet (AAAA12, 1010); also used to fill
+    // LocoSeriesStore
     static bool decodeLocoPacket(
-        const QByteArray &pkt,
+        QByteArrayView pkt,
         quint32 &locoId,
         quint32 &absLoc,
         quint16 &speed,
@@ -40,6 +56,18 @@ private:
         quint8  &direction,
         quint32 &frameNo
         );
+
+private:
+    static void collectSeries(
+        const QString &locoId,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &direction,
+        const QString &graphType,
+        const QString &logDir,
+        GraphSeries &out,
+        bool &hasData
+        );
 };
 
 #endif // GRAPH_BACKEND_H
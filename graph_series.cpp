@@ -0,0 +1,172 @@
+#include "graph_series.h"
+
+#include <QByteArray>
+#include <QCborTag>
+#include <QSysInfo>
+#include <QtEndian>
+#include <cstdlib>
+#include <cstring>
+
+QJsonObject GraphSeriesFormat::toJsonColumns(const GraphSeries &s)
+{
+    QJsonArray xArr, yArr;
+    for (qsizetype i = 0; i < s.size(); ++i) {
+        xArr.append(s.x.at(i));
+        yArr.append(s.y.at(i));
+    }
+
+    return {{"x", xArr}, {"y", yArr}};
+}
+
+QJsonArray GraphSeriesFormat::toJsonPoints(const GraphSeries &s)
+{
+    QJsonArray points;
+    for (qsizetype i = 0; i < s.size(); ++i)
+        points.append(QJsonObject{{"x", s.x.at(i)}, {"y", s.y.at(i)}});
+    return points;
+}
+
+QCborMap GraphSeriesFormat::toCbor(const GraphSeries &s)
+{
+    QCborMap m;
+    m.insert(QStringLiteral("x"), int32Array(s.x));
+    m.insert(QStringLiteral("y"), int32Array(s.y));
+    return m;
+}
+
+QCborValue GraphSeriesFormat::int32Array(const QVector<qint32> &values)
+{
+    QByteArray bytes(values.size() * qsizetype(sizeof(qint32)), Qt::Uninitialized);
+
+    // The column already is the wire layout on little endian hosts
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+        std::memcpy(bytes.data(), values.constData(), size_t(bytes.size()));
+    else
+        qToLittleEndian<qint32>(values.constData(), values.size(), bytes.data());
+
+    return QCborValue(QCborTag(TAG_INT32_LE), bytes);
+}
+
+// =====================================================
+// REDUCTION
+// =====================================================
+
+GraphReduction GraphReduction::fromQuery(const QString &downsample,
+                                         const QString &maxPoints)
+{
+    GraphReduction r;
+    r.maxPoints = qMax(0, maxPoints.toInt());
+
+    if (downsample == "minmax")
+        r.mode = MinMax;
+    else if (downsample == "lttb" || (downsample.isEmpty() && r.maxPoints > 0))
+        r.mode = Lttb;
+
+    if (r.mode != None && r.maxPoints == 0)
+        r.maxPoints = DEFAULT_MAX_POINTS;
+    else if (r.mode != None)
+        r.maxPoints = qMax<int>(MIN_MAX_POINTS, r.maxPoints);
+
+    return r;
+}
+
+GraphSeries GraphReduction::apply(const GraphSeries &s) const
+{
+    if (mode == None || s.size() <= maxPoints)
+        return s;
+
+    return mode == MinMax ? minMax(s, maxPoints) : lttb(s, maxPoints);
+}
+
+GraphSeries GraphReduction::lttb(const GraphSeries &s, int maxPoints)
+{
+    const qsizetype n = s.size();
+    const qsizetype m = qMax(3, maxPoints);
+    if (n <= m)
+        return s;
+
+    GraphSeries out;
+    out.x.reserve(m);
+    out.y.reserve(m);
+
+    // First and last points are kept; the rest is split into m - 2 buckets
+    const double every = double(n - 2) / double(m - 2);
+
+    qsizetype a = 0;
+    out.append(s.x.at(0), s.y.at(0));
+
+    for (qsizetype b = 0; b < m - 2; ++b) {
+        // Mean of the next bucket (the last point for the last bucket)
+        const qsizetype nextFrom = qsizetype((b + 1) * every) + 1;
+        const qsizetype nextTo = qMin(qsizetype((b + 2) * every) + 1, n);
+
+        double avgX = 0, avgY = 0;
+        for (qsizetype i = nextFrom; i < nextTo; ++i) {
+            avgX += s.x.at(i);
+            avgY += s.y.at(i);
+        }
+        const qsizetype nextCount = qMax<qsizetype>(1, nextTo - nextFrom);
+        avgX /= nextCount;
+        avgY /= nextCount;
+
+        // Point of this bucket with the largest triangle
+        const qsizetype from = qsizetype(b * every) + 1;
+        const qsizetype to = qsizetype((b + 1) * every) + 1;
+
+        const double ax = s.x.at(a);
+        const double ay = s.y.at(a);
+
+        double best = -1;
+        qsizetype pick = from;
+        for (qsizetype i = from; i < to; ++i) {
+            const double area = std::abs((ax - avgX) * (s.y.at(i) - ay) -
+                                         (ax - s.x.at(i)) * (avgY - ay));
+            if (area > best) {
+                best = area;
+                pick = i;
+            }
+        }
+
+        out.append(s.x.at(pick), s.y.at(pick));
+        a = pick;
+    }
+
+    out.append(s.x.at(n - 1), s.y.at(n - 1));
+    return out;
+}
+
+GraphSeries GraphReduction::minMax(const GraphSeries &s, int maxPoints)
+{
+    const qsizetype n = s.size();
+    const qsizetype buckets = qMax(1, maxPoints / 2);
+    if (n <= maxPoints)
+        return s;
+
+    GraphSeries out;
+    out.x.reserve(buckets * 2);
+    out.y.reserve(buckets * 2);
+
+    for (qsizetype b = 0; b < buckets; ++b) {
+        const qsizetype from = b * n / buckets;
+        const qsizetype to = (b + 1) * n / buckets;
+        if (from >= to)
+            continue;
+
+        qsizetype lo = from, hi = from;
+        for (qsizetype i = from + 1; i < to; ++i) {
+            if (s.y.at(i) < s.y.at(lo))
+                lo = i;
+            if (s.y.at(i) > s.y.at(hi))
+                hi = i;
+        }
+
+        // Both extremes, in series order
+        const qsizetype first = qMin(lo, hi);
+        const qsizetype second = qMax(lo, hi);
+        out.append(s.x.at(first), s.y.at(first));
+        if (second != first)
+            out.append(s.x.at(second), s.y.at(second));
+    }
+
+    return out;
+}
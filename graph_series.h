@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/*
+ * Numeric (x, y) series of the graph endpoints, kept as two int32
+ * columns until the response is encoded.
+ *
+ * JSON keeps the existing shapes ({"x":[...],"y":[...]} for
+ * /api/graph/data, [{"x":..,"y":..}, ...] for the track profile graph).
+ * CBOR writes each column as one RFC 8746 typed array: tag 78 (sint32,
+ * little endian) around a byte string holding the raw values, which a
+ * browser maps straight onto an Int32Array. No per-point value is built
+ * on that path.
+ *
+ * GraphReduction bounds a series to maxPoints before it is encoded, in
+ * one pass over the columns and in series order:
+ *   lttb   - Largest-Triangle-Three-Buckets: one point per bucket, the one
+ *            spanning the largest triangle with the previous pick and the
+ *            next bucket's mean; keeps the shape and most spikes
+ *   minmax - lowest and highest y of every bucket, so no peak (e.g. an
+ *            overspeed) is ever dropped; up to maxPoints points
+ */
+
+struct GraphSeries
+{
+    QVector<qint32> x;
+    QVector<qint32> y;
+
+    qsizetype size() const { return x.size(); }
+    bool isEmpty() const { return x.isEmpty(); }
+
+    void append(qint32 xv, qint32 yv)
+    {
+        x.append(xv);
+        y.append(yv);
+    }
+
+    void append(const GraphSeries &other)
+    {
+        x += other.x;
+        y += other.y;
+    }
+};
+
+struct GraphReduction
+{
+    enum Mode { None, Lttb, MinMax };
+
+    static constexpr int DEFAULT_MAX_POINTS = 2000;
+    static constexpr int MIN_MAX_POINTS = 3;      // lttb keeps first + last
+
+    Mode mode = None;
+    int maxPoints = 0;
+
+    // downsample=lttb|minmax, maxPoints=N; maxPoints alone means lttb,
+    // a mode alone DEFAULT_MAX_POINTS. maxPoints is raised to
+    // MIN_MAX_POINTS, below which neither mode can hold the cap.
+    static GraphReduction fromQuery(const QString &downsample, const QString &maxPoints);
+
+    // 's' itself when it already fits
+    GraphSeries apply(const GraphSeries &s) const;
+
+    static GraphSeries lttb(const GraphSeries &s, int maxPoints);
+    static GraphSeries minMax(const GraphSeries &s, int maxPoints);
+};
+
+class GraphSeriesFormat
+{
+public:
+    // RFC 8746: sint32 little endian typed array
+    static constexpr quint64 TAG_INT32_LE = 78;
+
+    // {"x": [...], "y": [...]}
+    static QJsonObject toJsonColumns(const GraphSeries &s);
+
+    // [{"x": .., "y": ..}, ...]
+    static QJsonArray toJsonPoints(const GraphSeries &s);
+
+    // {"x": typed array, "y": typed array}
+    static QCborMap toCbor(const GraphSeries &s);
+
+    static QCborValue int32Array(const QVector<qint32> &values);
+};
@@ -0,0 +1,261 @@
+#include "hex_decoder.h"
+
+#include <array>
+
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#  define RGS_HEX_SIMD 1
+#  include <immintrin.h>
+#endif
+
+// =====================================================
+// SCALAR LOOKUP
+// =====================================================
+
+static constexpr qint8 HEX_INVALID = -1;
+static constexpr qint8 HEX_SKIP    = -2;
+
+static constexpr std::array<qint8, 256> makeHexTable()
+{
+    std::array<qint8, 256> t{};
+
+    for (int c = 0; c < 256; ++c)
+        t[c] = HEX_INVALID;
+
+    for (int c = '0'; c <= '9'; ++c) t[c] = qint8(c - '0');
+    for (int c = 'A'; c <= 'F'; ++c) t[c] = qint8(c - 'A' + 10);
+    for (int c = 'a'; c <= 'f'; ++c) t[c] = qint8(c - 'a' + 10);
+
+    t['\r'] = t['\n'] = t[' '] = t['\t'] = HEX_SKIP;
+    return t;
+}
+
+static constexpr std::array<qint8, 256> HEX_TABLE = makeHexTable();
+
+// Returns the number of input chars consumed; always a multiple of the
+// kernel block size, stopping at the first block that is not pure hex.
+using HexKernel = qsizetype (*)(const char* src, qsizetype length, quint8* dst);
+
+#ifdef RGS_HEX_SIMD
+
+// =====================================================
+// AVX2 KERNEL (32 chars → 16 bytes)
+// =====================================================
+
+__attribute__((target("avx2")))
+static qsizetype decodeAvx2(const char* src, qsizetype length, quint8* dst)
+{
+    const __m256i zeroLo  = _mm256_set1_epi8('0' - 1);
+    const __m256i nineHi  = _mm256_set1_epi8('9' + 1);
+    const __m256i aLo     = _mm256_set1_epi8('a' - 1);
+    const __m256i fHi     = _mm256_set1_epi8('f' + 1);
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    const __m256i digitOff = _mm256_set1_epi8('0');
+    const __m256i alphaOff = _mm256_set1_epi8('a' - 10);
+    const __m256i weights = _mm256_set1_epi16(0x0110); // hi * 16 + lo
+
+    qsizetype done = 0;
+
+    while (length - done >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + done));
+        __m256i lower = _mm256_or_si256(v, caseBit);
+
+        __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(v, zeroLo),
+                                           _mm256_cmpgt_epi8(nineHi, v));
+        __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, aLo),
+                                           _mm256_cmpgt_epi8(fHi, lower));
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) != -1)
+            break;
+
+        __m256i nibbles = _mm256_blendv_epi8(_mm256_sub_epi8(lower, alphaOff),
+                                             _mm256_sub_epi8(v, digitOff),
+                                             isDigit);
+
+        __m256i words = _mm256_maddubs_epi16(nibbles, weights);
+        __m256i packed = _mm256_packus_epi16(words, words);
+        packed = _mm256_permute4x64_epi64(packed, 0x08);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + done / 2),
+                         _mm256_castsi256_si128(packed));
+        done += 32;
+    }
+
+    return done;
+}
+
+// =====================================================
+// SSE4.1 KERNEL (16 chars → 8 bytes)
+// =====================================================
+
+__attribute__((target("sse4.1")))
+static qsizetype decodeSse41(const char* src, qsizetype length, quint8* dst)
+{
+    const __m128i zeroLo  = _mm_set1_epi8('0' - 1);
+    const __m128i nineHi  = _mm_set1_epi8('9' + 1);
+    const __m128i aLo     = _mm_set1_epi8('a' - 1);
+    const __m128i fHi     = _mm_set1_epi8('f' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i digitOff = _mm_set1_epi8('0');
+    const __m128i alphaOff = _mm_set1_epi8('a' - 10);
+    const __m128i weights = _mm_set1_epi16(0x0110);
+
+    qsizetype done = 0;
+
+    while (length - done >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + done));
+        __m128i lower = _mm_or_si128(v, caseBit);
+
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(v, zeroLo),
+                                        _mm_cmpgt_epi8(nineHi, v));
+        __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, aLo),
+                                        _mm_cmpgt_epi8(fHi, lower));
+
+        if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xFFFF)
+            break;
+
+        __m128i nibbles = _mm_blendv_epi8(_mm_sub_epi8(lower, alphaOff),
+                                          _mm_sub_epi8(v, digitOff),
+                                          isDigit);
+
+        __m128i words = _mm_maddubs_epi16(nibbles, weights);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + done / 2),
+                         _mm_packus_epi16(words, words));
+        done += 16;
+    }
+
+    return done;
+}
+
+#endif // RGS_HEX_SIMD
+
+struct HexKernelChoice
+{
+    HexKernel fn = nullptr;
+    const char* name = "scalar";
+    qsizetype block = 0;
+};
+
+static HexKernelChoice pickKernel()
+{
+    HexKernelChoice k;
+
+#ifdef RGS_HEX_SIMD
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        k = {decodeAvx2, "avx2", 32};
+    else if (__builtin_cpu_supports("sse4.1"))
+        k = {decodeSse41, "sse4.1", 16};
+#endif
+
+    return k;
+}
+
+static const HexKernelChoice& kernel()
+{
+    static const HexKernelChoice k = pickKernel();
+    return k;
+}
+
+// =====================================================
+// PUBLIC API
+// =====================================================
+
+qsizetype HexDecoder::decode(const char* src, qsizetype length,
+                             quint8* dst, qsizetype capacity)
+{
+    const HexKernelChoice& k = kernel();
+
+    qsizetype i = 0;
+    qsizetype out = 0;
+    int hi = -1;
+
+    // After a block that is not pure hex, stay scalar for that many chars
+    qsizetype scalarUntil = 0;
+
+    while (i < length) {
+
+        if (k.fn && hi < 0 && i >= scalarUntil) {
+            qsizetype room = (capacity - out) * 2;
+            qsizetype n = k.fn(src + i, qMin(length - i, room), dst + out);
+
+            i += n;
+            out += n / 2;
+
+            if (i >= length)
+                break;
+
+            scalarUntil = i + k.block;
+        }
+
+        qint8 v = HEX_TABLE[static_cast<quint8>(src[i++])];
+
+        if (v == HEX_SKIP)
+            continue;
+
+        if (v == HEX_INVALID)
+            return -1;
+
+        if (hi < 0) {
+            hi = v;
+            continue;
+        }
+
+        if (out >= capacity)
+            return -1;
+
+        dst[out++] = quint8((hi << 4) | v);
+        hi = -1;
+    }
+
+    return out;
+}
+
+bool HexDecoder::decode(QByteArrayView hex, QByteArray& out)
+{
+    out.resize(hex.size() / 2);
+
+    qsizetype n = decode(hex.data(), hex.size(),
+                         reinterpret_cast<quint8*>(out.data()), out.size());
+    if (n < 0) {
+        out.resize(0);
+        return false;
+    }
+
+    out.resize(n);
+    return true;
+}
+
+bool HexDecoder::startsWith(QByteArrayView hex, QByteArrayView upperPrefix)
+{
+    if (hex.size() < upperPrefix.size())
+        return false;
+
+    for (qsizetype i = 0; i < upperPrefix.size(); ++i) {
+        char c = hex[i];
+        if (c >= 'a' && c <= 'f')
+            c -= 'a' - 'A';
+        if (c != upperPrefix[i])
+            return false;
+    }
+    return true;
+}
+
+bool HexDecoder::nextLine(QByteArrayView text, qsizetype& pos, QByteArrayView& line)
+{
+    if (pos >= text.size())
+        return false;
+
+    qsizetype nl = text.indexOf('\n', pos);
+    if (nl < 0)
+        nl = text.size();
+
+    line = text.sliced(pos, nl - pos).trimmed();
+    pos = nl + 1;
+    return true;
+}
+
+const char* HexDecoder::kernelName()
+{
+    return kernel().name;
+}
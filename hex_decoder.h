@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtGlobal>
+
+/*
+ * ASCII hex → bytes for the "*.bin" log text.
+ *
+ * Accepts upper and lower case digits and skips CR/LF, spaces and tabs.
+ * Output goes to a caller supplied buffer so a single buffer can be
+ * reused for every line of a day file. Blocks of plain hex are decoded
+ * with AVX2 or SSE4.1 when the CPU has them, with a scalar fallback.
+ */
+
+class HexDecoder
+{
+public:
+    // Decode into dst. Returns the number of bytes written, or -1 when a
+    // non-hex character is found or dst is too small. A dangling final
+    // nibble is ignored.
+    static qsizetype decode(const char* src, qsizetype length,
+                            quint8* dst, qsizetype capacity);
+
+    // Decode into 'out', resizing it (capacity is kept between calls).
+    static bool decode(QByteArrayView hex, QByteArray& out);
+
+    // Case-insensitive prefix test on hex text, e.g. startsWith(line, "AAAA19").
+    static bool startsWith(QByteArrayView hex, QByteArrayView upperPrefix);
+
+    // Next line of an in-memory log (trimmed, no copy). Advances 'pos';
+    // returns false once the text is exhausted.
+    static bool nextLine(QByteArrayView text, qsizetype& pos, QByteArrayView& line);
+
+    // Name of the kernel picked at runtime ("avx2", "sse4.1", "scalar").
+    static const char* kernelName();
+};
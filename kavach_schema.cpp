@@ -0,0 +1,191 @@
+#include "kavach_schema.h"
+
+#include <QJsonArray>
+#include <QList>
+
+#define JNUM(x) QJsonValue(static_cast<qint64>(x))
+
+namespace KavachSchema
+{
+
+// =====================================================
+// DERIVED VALUES
+// =====================================================
+
+QJsonValue authorizedSpeedKmph(qint64 raw)
+{
+    if (raw >= 1 && raw <= 50)
+        return JNUM(raw * 5);
+    if (raw >= 51 && raw <= 61)
+        return "Reserved";
+    if (raw == 62)
+        return 8;
+    if (raw == 63)
+        return "Unknown";
+    return QJsonValue(QJsonValue::Undefined);
+}
+
+QJsonValue gradientDesc(qint64 raw)
+{
+    if (raw <= 30)
+        return QString("Gradient class %1").arg(raw);
+    return "RESERVED";
+}
+
+QJsonValue trackConditionType(qint64 raw)
+{
+    if (raw <= 9)
+        return JNUM(raw);
+    return "Reserved";
+}
+
+QJsonValue tsrUniversalSpeedKmph(qint64 raw)
+{
+    if (raw == 0)
+        return "Dead Stop";
+    if (raw >= 1 && raw <= 40)
+        return JNUM(raw * 5);
+    if (raw == 62)
+        return 8;
+    if (raw == 63)
+        return "Unknown";
+    return "Reserved";
+}
+
+QJsonValue tsrWhistle(qint64 raw)
+{
+    switch (raw) {
+    case 0:  return "No Whistle";
+    case 1:  return "Whistle Blow";
+    default: return "Spare";
+    }
+}
+
+// =====================================================
+// JSON VISITOR
+// =====================================================
+
+// Writes values into the row; repeated groups become arrays of objects
+// (or of numbers for ScalarItems).
+class JsonSink
+{
+public:
+    explicit JsonSink(QJsonObject& row) : m_row(row) {}
+
+    void value(const Field& f, qint64 raw)
+    {
+        if (!m_stack.isEmpty() && (m_stack.last().repeat->flags & ScalarItems)) {
+            m_stack.last().array.append(JNUM(raw));
+            return;
+        }
+
+        QJsonObject& target = current();
+
+        if (f.key)
+            target[f.key] = JNUM(raw);
+        if (f.alias)
+            target[f.alias] = JNUM(raw);
+
+        if (f.derive) {
+            QJsonValue d = f.derive(raw);
+            if (!d.isUndefined())
+                target[f.derivedKey] = d;
+        }
+    }
+
+    void beginRepeat(const Field& f) { m_stack.append(Level{&f, {}, {}}); }
+    void beginItem(const Field&) { m_stack.last().item = QJsonObject(); }
+
+    void endItem(const Field& f)
+    {
+        if (!(f.flags & ScalarItems))
+            m_stack.last().array.append(m_stack.last().item);
+    }
+
+    void endRepeat(const Field& f)
+    {
+        QJsonArray array = m_stack.takeLast().array;
+        current()[f.key] = array;
+    }
+
+private:
+    struct Level
+    {
+        const Field* repeat;
+        QJsonArray array;
+        QJsonObject item;
+    };
+
+    QJsonObject& current()
+    {
+        return m_stack.isEmpty() ? m_row : m_stack.last().item;
+    }
+
+    QJsonObject& m_row;
+    QList<Level> m_stack;
+};
+
+// =====================================================
+// PACKETS
+// =====================================================
+
+static const SubPacket* findSubPacket(qint64 type)
+{
+    for (const SubPacket& sp : SUB_PACKETS)
+        if (sp.type == type)
+            return &sp;
+    return nullptr;
+}
+
+void decodeRegular(const quint8* payload, qint64 lengthBytes, QJsonObject& row)
+{
+    const qint64 totalBits = lengthBytes * 8;
+
+    Cursor c{payload, lengthBytes, 0, totalBits};
+    JsonSink sink(row);
+
+    walk(REGULAR_HEADER, c, sink);
+
+    // Sub-packets run up to the trailing MAC + CRC (64 bits)
+    const qint64 payloadEnd = totalBits - 64;
+
+    while (c.pos + SUB_PACKET_HEADER_BITS <= payloadEnd) {
+
+        const qint64 type = readField(c, 4, false);
+        const qint64 len  = readField(c, 7, false); // bytes
+
+        const qint64 subEnd = c.pos + len * 8;
+
+        if (const SubPacket* sp = findSubPacket(type)) {
+
+            if (sp->presentKey)
+                row[sp->presentKey] = true;
+            row[sp->typeKey]   = JNUM(type);
+            row[sp->lengthKey] = JNUM(len);
+
+            qint64 last = 0;
+            c.limit = subEnd;
+            walk(sp->fields, 0, sp->count, c, sink, last);
+            c.limit = totalBits;
+        }
+
+        if (c.pos < subEnd)
+            c.pos = subEnd;
+    }
+}
+
+void decodeAccess(const quint8* payload, qint64 lengthBytes, QJsonObject& row)
+{
+    Cursor c{payload, lengthBytes, 0, lengthBytes * 8};
+    JsonSink sink(row);
+    walk(ACCESS_PACKET, c, sink);
+}
+
+void decodeEmergency(const quint8* payload, qint64 lengthBytes, QJsonObject& row)
+{
+    Cursor c{payload, lengthBytes, 0, lengthBytes * 8};
+    JsonSink sink(row);
+    walk(EMERGENCY_PACKET, c, sink);
+}
+
+} // namespace KavachSchema
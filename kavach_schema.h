@@ -0,0 +1,571 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QtGlobal>
+#include <cstddef>
+#include <iterator>
+
+#include "bit_reader.h"
+
+/*
+ * Compile-time field tables for the Stationary Kavach packets
+ * (Annexure-C): Regular 1001 header and sub-packets 0..7,
+ * Access 1011 and Emergency 1100.
+ *
+ * Each table is a flat list of fields in wire order. Conditional and
+ * repeated groups are bracketed by If/Else/EndIf and Repeat/EndRepeat;
+ * both look at the value of the field read immediately before them.
+ *
+ * walk() runs a table directly over the payload bytes and hands every
+ * field to a visitor, so the JSON serializer and any other consumer
+ * share one decoder. fieldPos() resolves fixed-offset header fields at
+ * compile time for cheap projections (e.g. DEST_LOCO_ID of a 1001
+ * packet without decoding the rest).
+ */
+
+namespace KavachSchema
+{
+
+enum class Op : quint8
+{
+    Value,      // read 'bits', emit under key/alias/derivedKey
+    Spare,      // skip 'bits'
+    If,         // previous value in [lo, hi]
+    Else,
+    EndIf,
+    Repeat,     // previous value = item count, array under key
+    EndRepeat
+};
+
+enum Flag : quint8
+{
+    Signed           = 0x01, // two's complement value
+    ClampToSubPacket = 0x02, // Repeat: never read past the sub-packet end
+    ScalarItems      = 0x04  // Repeat: array of plain numbers, not objects
+};
+
+// Maps a raw field value to an extra JSON value (Undefined = omit).
+using Derive = QJsonValue (*)(qint64 raw);
+
+struct Field
+{
+    Op op = Op::Value;
+    const char* key = nullptr;
+    const char* alias = nullptr;
+    quint8 bits = 0;
+    quint8 flags = 0;
+    qint32 lo = 0;
+    qint32 hi = -1;
+    Derive derive = nullptr;
+    const char* derivedKey = nullptr;
+};
+
+// ---------------- table builders ----------------
+
+constexpr Field V(const char* key, int bits, quint8 flags = 0)
+{
+    return {Op::Value, key, nullptr, quint8(bits), flags};
+}
+
+// Same value under its Annexure name and a simplified UI name
+constexpr Field VA(const char* key, const char* alias, int bits)
+{
+    return {Op::Value, key, alias, quint8(bits)};
+}
+
+// Value with a derived field; 'key' may be null to emit only the derived one
+constexpr Field VD(const char* key, int bits, Derive derive, const char* derivedKey)
+{
+    return {Op::Value, key, nullptr, quint8(bits), 0, 0, -1, derive, derivedKey};
+}
+
+constexpr Field Spare(int bits)
+{
+    return {Op::Spare, nullptr, nullptr, quint8(bits)};
+}
+
+constexpr Field If(int lo, int hi) { return {Op::If, nullptr, nullptr, 0, 0, lo, hi}; }
+constexpr Field IfEq(int v) { return If(v, v); }
+constexpr Field Else() { return {Op::Else}; }
+constexpr Field EndIf() { return {Op::EndIf}; }
+
+// maxCount >= 0: counts above it read no items at all
+constexpr Field Repeat(const char* arrayKey, quint8 flags = 0, int maxCount = -1)
+{
+    return {Op::Repeat, arrayKey, nullptr, 0, flags, 0, maxCount};
+}
+
+constexpr Field EndRepeat() { return {Op::EndRepeat}; }
+
+// ---------------- derived values ----------------
+
+QJsonValue authorizedSpeedKmph(qint64 raw);
+QJsonValue gradientDesc(qint64 raw);
+QJsonValue trackConditionType(qint64 raw);
+QJsonValue tsrUniversalSpeedKmph(qint64 raw);
+QJsonValue tsrWhistle(qint64 raw);
+
+// =====================================================
+// REGULAR PACKET (1001) HEADER — 104 bits
+// =====================================================
+
+inline constexpr Field REGULAR_HEADER[] = {
+    V("pkt_type", 4),
+    V("pkt_length", 10),
+    V("frame_number", 17),
+    V("source_stn_id", 16),
+    V("source_version", 3),
+    V("dest_loco_id", 20),
+    V("ref_profile_id", 4),
+    V("last_ref_rfid", 10),
+    V("dist_pkt_start_m", 15, Signed),
+    V("pkt_direction", 2),
+    Spare(3),
+};
+
+// Every sub-packet starts with NID_SUB_PKT (4) + SUB_PKT_LEN (7, bytes)
+constexpr int SUB_PACKET_HEADER_BITS = 11;
+
+// =====================================================
+// 0000 – MOVEMENT AUTHORITY
+// =====================================================
+
+inline constexpr Field SUB_MA[] = {
+    V("ma_frame_offset", 4),
+    V("dest_loco_sos", 4),
+    V("train_section_type", 2),
+
+    // signal info a16..a0
+    V("sig_stop", 1),
+    V("sig_override", 1),
+    V("sig_type", 6),
+    V("sig_line_name", 4),
+    V("sig_line_no", 5),
+
+    V("cur_signal_aspect", 6),
+    V("next_signal_aspect", 6),
+    V("approaching_signal_dist_m", 15),
+
+    V("authority_type", 2),
+    IfEq(1), // OS: authorized speed present
+        VD("authorized_speed", 6, authorizedSpeedKmph, "authorized_speed_kmph"),
+    Else(),
+        Spare(6),
+    EndIf(),
+
+    V("ma_distance_m", 16),
+
+    V("req_shorten_ma", 1),
+    IfEq(1),
+        V("new_ma_distance_m", 16),
+    EndIf(),
+
+    V("trn_len_info_sts", 1),
+    IfEq(1),
+        V("trn_len_info_type", 1),
+        V("ref_frame_num_tlm", 17),
+        V("ref_offset_int_tlm", 8),
+    EndIf(),
+
+    V("next_station_comm", 1),
+    IfEq(1),
+        V("approaching_station_id", 16),
+    EndIf(),
+};
+
+// =====================================================
+// 0001 – STATIC SPEED PROFILE (SSP)
+// =====================================================
+
+inline constexpr Field SUB_SSP[] = {
+    V("lm_speed_info_cnt", 5),
+    Repeat("static_speed_profile"),
+        V("distance_m", 15),
+        V("speed_class", 1),
+        IfEq(0),
+            V("lm_static_speed_value_raw", 6),
+        Else(),
+            V("speed_A_raw", 6),
+            V("speed_B_raw", 6),
+            V("speed_C_raw", 6),
+        EndIf(),
+    EndRepeat(),
+};
+
+// =====================================================
+// 0010 – GRADIENT PROFILE
+// =====================================================
+
+inline constexpr Field SUB_GRADIENT[] = {
+    V("lm_grad_info_cnt", 5),
+    Repeat("gradient_profile"),
+        V("distance_m", 15),
+        V("direction", 1),   // 0 = downhill, 1 = uphill
+        VD("gradient_raw", 5, gradientDesc, "gradient_desc"),
+    EndRepeat(),
+};
+
+// =====================================================
+// 0011 – LC GATE PROFILE
+// =====================================================
+
+inline constexpr Field SUB_LC_GATE[] = {
+    VA("lm_lc_info_cnt", "lc_gate_count", 5),
+    Repeat("lc_gate_profile"),
+        VA("lm_lc_distance", "distance_m", 15),
+        VA("lm_lc_id_numeric", "lc_id_numeric", 10),
+        VA("lm_lc_id_alpha_suffix", "lc_id_suffix", 3),
+        VA("lm_lc_manning_type", "manning_type", 1),
+        VA("lm_lc_class", "lc_class", 3),
+        VA("lm_lc_autowhistling_enabled", "auto_whistling_enabled", 1),
+        VA("lm_lc_auto_whistling_type", "auto_whistling_type", 2),
+    EndRepeat(),
+};
+
+// =====================================================
+// 0100 – TURNOUT SPEED PROFILE
+// =====================================================
+
+inline constexpr Field SUB_TURNOUT[] = {
+    V("to_cnt", 2),
+    Repeat("turnout_speed_profile"),
+        VA("lm_to_speed_raw", "turnout_speed_code", 5),
+        If(1, 18), // restricted speed
+            VA("lm_diff_dist_to", "start_distance_m", 15),
+            VA("lm_to_speed_rel_dist", "release_distance_m", 12),
+        EndIf(),
+    EndRepeat(),
+};
+
+// =====================================================
+// 0101 – TAG LINKING INFORMATION
+// =====================================================
+
+inline constexpr Field SUB_TAG_LINKING[] = {
+    V("dist_dup_tag_m", 4),
+    V("route_rfid_count", 6),
+    Repeat("rfid_list", ClampToSubPacket),
+        V("dist_next_rfid_m", 11),
+        V("rfid_tag_id", 10),
+        V("dup_tag_dir", 1),
+    EndRepeat(),
+
+    V("abs_loc_reset", 1),
+    IfEq(1),
+        V("loc_reset_start_dist_m", 15),
+        V("adj_loco_dir", 2),
+        V("abs_loc_correction_m", 23),
+        V("adjacent_line_count", 3),
+        Repeat("adjacent_line_tins", ScalarItems, 5),
+            V("line_tin", 9),
+        EndRepeat(),
+    EndIf(),
+};
+
+// =====================================================
+// 0110 – TRACK CONDITION DATA
+// =====================================================
+
+inline constexpr Field SUB_TRACK_CONDITION[] = {
+    V("track_condition_count", 4),
+    Repeat("track_conditions"),
+        VD("track_condition_type_raw", 4, trackConditionType, "track_condition_type"),
+        V("start_dist_m", 15),
+        V("length_m", 15),
+    EndRepeat(),
+};
+
+// =====================================================
+// 0111 – TEMPORARY SPEED RESTRICTION (TSR) PROFILE
+// =====================================================
+
+inline constexpr Field SUB_TSR[] = {
+    V("tsr_status", 2),
+    IfEq(2), // latest TSR info follows
+        V("tsr_info_cnt", 5),
+        Repeat("tsr_list"),
+            V("tsr_id", 8),
+            V("tsr_distance_m", 15),
+            V("tsr_length_m", 15),
+            V("tsr_class", 1),
+            IfEq(0), // universal speed
+                VD(nullptr, 6, tsrUniversalSpeedKmph, "tsr_universal_speed_kmph"),
+            Else(),  // classified speed A / B / C
+                V("tsr_classA_speed", 6),
+                V("tsr_classB_speed", 6),
+                V("tsr_classC_speed", 6),
+            EndIf(),
+            VD("tsr_whistle_raw", 2, tsrWhistle, "tsr_whistle"),
+        EndRepeat(),
+    EndIf(),
+};
+
+// =====================================================
+// SUB-PACKET REGISTRY
+// =====================================================
+
+struct SubPacket
+{
+    quint8 type;
+    const Field* fields;
+    int count;
+    const char* typeKey;
+    const char* lengthKey;
+    const char* presentKey; // "has_..." flag, null when not reported
+};
+
+template <std::size_t N>
+constexpr SubPacket subPacket(quint8 type, const Field (&fields)[N],
+                              const char* typeKey, const char* lengthKey,
+                              const char* presentKey)
+{
+    return {type, fields, int(N), typeKey, lengthKey, presentKey};
+}
+
+inline constexpr SubPacket SUB_PACKETS[] = {
+    subPacket(0, SUB_MA,              "sub_pkt_type_ma",    "sub_pkt_length_ma", nullptr),
+    subPacket(1, SUB_SSP,             "sub_pkt_type_ssp",   "sub_pkt_len_ssp",   "has_static_speed_profile"),
+    subPacket(2, SUB_GRADIENT,        "sub_pkt_type_grad",  "sub_pkt_len_grad",  "has_gradient_profile"),
+    subPacket(3, SUB_LC_GATE,         "sub_pkt_type_lc",    "sub_pkt_len_lc",    "has_lc_gate_profile"),
+    subPacket(4, SUB_TURNOUT,         "sub_pkt_type_to",    "sub_pkt_len_to",    "has_turnout_profile"),
+    subPacket(5, SUB_TAG_LINKING,     "sub_pkt_type_tag",   "sub_pkt_len_tag",   "has_tag_linking"),
+    subPacket(6, SUB_TRACK_CONDITION, "sub_pkt_type_track", "sub_pkt_len_track", "has_track_condition"),
+    subPacket(7, SUB_TSR,             "sub_pkt_type_tsr",   "sub_pkt_len_tsr",   "has_tsr_profile"),
+};
+
+// =====================================================
+// ACCESS PACKET (1011)
+// =====================================================
+
+inline constexpr Field ACCESS_PACKET[] = {
+    V("pkt_type", 4),
+    V("pkt_length", 7),
+    V("frame_number", 17),
+    V("source_stn_id", 16),
+    V("source_version", 3),
+    V("stn_location_m", 23),
+    V("dest_loco_id", 20),
+    V("uplink_freq_channel", 12),
+    V("downlink_freq_channel", 12),
+    V("tdma_timeslot", 7),
+    V("stn_random_rs", 16),
+    V("stn_tdma", 7),
+    V("mac_code", 32),
+    V("pkt_crc", 32),
+};
+
+// =====================================================
+// ADDITIONAL EMERGENCY PACKET (1100)
+// =====================================================
+
+inline constexpr Field EMERGENCY_PACKET[] = {
+    V("pkt_type", 4),
+    V("pkt_length", 7),
+    V("frame_number", 17),
+    V("source_stn_id", 16),
+    V("source_version", 3),
+    V("stn_location_m", 23),
+    V("gen_sos_call", 1),
+    Spare(1),
+    V("pkt_crc", 32),
+};
+
+// =====================================================
+// DECODER
+// =====================================================
+
+struct Cursor
+{
+    const quint8* data;
+    qint64 lengthBytes;
+    qint64 pos = 0;   // bit position
+    qint64 limit = 0; // end of the current sub-packet (bits)
+};
+
+inline qint64 readField(Cursor& c, int bits, bool isSigned)
+{
+    quint64 v = BitReader::extract(c.data, c.lengthBytes, c.pos, bits);
+    c.pos += bits;
+
+    if (isSigned && bits > 0 && (v & (quint64(1) << (bits - 1))))
+        return qint64(v) - (qint64(1) << bits);
+    return qint64(v);
+}
+
+// Index of the Else/EndIf (or EndRepeat) closing the block opened at 'open'.
+constexpr int closingIndex(const Field* f, int open, int end, bool stopAtElse)
+{
+    int depth = 0;
+    for (int i = open + 1; i < end; ++i) {
+        const Op op = f[i].op;
+        if (op == Op::If || op == Op::Repeat)
+            ++depth;
+        else if (op == Op::EndIf || op == Op::EndRepeat) {
+            if (depth == 0)
+                return i;
+            --depth;
+        }
+        else if (op == Op::Else && depth == 0 && stopAtElse)
+            return i;
+    }
+    return end;
+}
+
+// Size of a block with no conditionals inside (-1 otherwise).
+constexpr int fixedBits(const Field* f, int begin, int end)
+{
+    int bits = 0;
+    for (int i = begin; i < end; ++i) {
+        if (f[i].op != Op::Value && f[i].op != Op::Spare)
+            return -1;
+        bits += f[i].bits;
+    }
+    return bits;
+}
+
+/*
+ * Visitor interface:
+ *   void value(const Field&, qint64 raw);
+ *   void beginRepeat(const Field&);
+ *   void beginItem(const Field&);
+ *   void endItem(const Field&);
+ *   void endRepeat(const Field&);
+ */
+template <typename Visitor>
+void walk(const Field* f, int begin, int end, Cursor& c, Visitor& v, qint64& last)
+{
+    int i = begin;
+
+    while (i < end) {
+        const Field& fd = f[i];
+
+        switch (fd.op) {
+        case Op::Value:
+            last = readField(c, fd.bits, fd.flags & Signed);
+            v.value(fd, last);
+            ++i;
+            break;
+
+        case Op::Spare:
+            c.pos += fd.bits;
+            ++i;
+            break;
+
+        case Op::If: {
+            const int mid   = closingIndex(f, i, end, true);
+            const int close = (mid < end && f[mid].op == Op::Else)
+                                  ? closingIndex(f, mid, end, false)
+                                  : mid;
+
+            if (last >= fd.lo && last <= fd.hi)
+                walk(f, i + 1, mid, c, v, last);
+            else if (mid != close)
+                walk(f, mid + 1, close, c, v, last);
+
+            i = close + 1;
+            break;
+        }
+
+        case Op::Repeat: {
+            const int close = closingIndex(f, i, end, false);
+
+            qint64 count = last;
+            if (fd.hi >= 0 && count > fd.hi)
+                count = 0;
+
+            if (fd.flags & ClampToSubPacket) {
+                const int entry = fixedBits(f, i + 1, close);
+                if (entry > 0)
+                    count = qMin(count, (c.limit - c.pos) / entry);
+            }
+
+            v.beginRepeat(fd);
+            for (qint64 k = 0; k < count; ++k) {
+                v.beginItem(fd);
+                walk(f, i + 1, close, c, v, last);
+                v.endItem(fd);
+            }
+            v.endRepeat(fd);
+
+            i = close + 1;
+            break;
+        }
+
+        default: // stray Else/EndIf/EndRepeat
+            ++i;
+            break;
+        }
+    }
+}
+
+template <typename Visitor, std::size_t N>
+void walk(const Field (&table)[N], Cursor& c, Visitor& v)
+{
+    qint64 last = 0;
+    walk(table, 0, int(N), c, v, last);
+}
+
+// =====================================================
+// PROJECTIONS
+// =====================================================
+
+struct FieldPos
+{
+    int offset = -1; // -1: not in the fixed-offset prefix
+    int bits = 0;
+    bool isSigned = false;
+};
+
+constexpr bool sameKey(const char* a, const char* b)
+{
+    if (!a || !b)
+        return false;
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+template <std::size_t N>
+constexpr FieldPos fieldPos(const Field (&table)[N], const char* key)
+{
+    int offset = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        const Field& f = table[i];
+        if (f.op != Op::Value && f.op != Op::Spare)
+            break;
+        if (f.op == Op::Value && sameKey(f.key, key))
+            return {offset, f.bits, bool(f.flags & Signed)};
+        offset += f.bits;
+    }
+    return {};
+}
+
+inline qint64 project(const quint8* data, qint64 lengthBytes, FieldPos f)
+{
+    Cursor c{data, lengthBytes, f.offset};
+    return readField(c, f.bits, f.isSigned);
+}
+
+inline constexpr FieldPos REGULAR_DEST_LOCO_ID   = fieldPos(REGULAR_HEADER, "dest_loco_id");
+inline constexpr FieldPos REGULAR_REF_PROFILE_ID = fieldPos(REGULAR_HEADER, "ref_profile_id");
+inline constexpr FieldPos REGULAR_PKT_DIRECTION  = fieldPos(REGULAR_HEADER, "pkt_direction");
+
+constexpr int REGULAR_HEADER_BITS = fixedBits(REGULAR_HEADER, 0, int(std::size(REGULAR_HEADER)));
+
+static_assert(REGULAR_HEADER_BITS == 104, "1001 header must be 104 bits");
+static_assert(REGULAR_DEST_LOCO_ID.offset == 50, "DEST_LOCO_ID offset");
+static_assert(REGULAR_PKT_DIRECTION.offset == 99, "PKT_DIR offset");
+
+// =====================================================
+// JSON
+// =====================================================
+
+// Decode the packets into 'row' using the table keys.
+void decodeRegular(const quint8* payload, qint64 lengthBytes, QJsonObject& row);
+void decodeAccess(const quint8* payload, qint64 lengthBytes, QJsonObject& row);
+void decodeEmergency(const quint8* payload, qint64 lengthBytes, QJsonObject& row);
+
+} // namespace KavachSchema
@@ -0,0 +1,67 @@
+#include "loco_series_store.h"
+#include "day_cache.h"
+#include "graph_backend.h"
+
+qint64 LocoDaySeries::memoryCost() const
+{
+    qint64 cost = 0;
+    for (const LocoColumns& c : locos)
+        cost += qint64(c.size()) * (2 * sizeof(quint32) + sizeof(quint16) + 2 * sizeof(quint8));
+    return cost;
+}
+
+void LocoDaySeries::squeeze()
+{
+    for (LocoColumns& c : locos) {
+        c.frame.squeeze();
+        c.location.squeeze();
+        c.speed.squeeze();
+        c.mode.squeeze();
+        c.direction.squeeze();
+    }
+}
+
+// =====================================================
+// CACHE
+// =====================================================
+
+static DayCache<LocoDaySeries>& seriesCache()
+{
+    static DayCache<LocoDaySeries> cache(qint64(64) << 20);
+    return cache;
+}
+
+void LocoSeriesStore::setCacheBudget(qint64 bytes)
+{
+    seriesCache().setBudget(bytes);
+}
+
+// =====================================================
+// FILL
+// =====================================================
+
+static void fillDay(LogScanner& scanner, LocoDaySeries& series)
+{
+    scanner.on(0x12, [&series](const LogPacket& pkt)
+    {
+        quint32 loco, loc, frame;
+        quint16 speed;
+        quint8 dirVal, mode;
+
+        if (!GraphBackend::decodeLocoPacket(QByteArrayView(pkt.data, pkt.length),
+                                            loco, loc, speed, mode, dirVal, frame))
+            return;
+
+        LocoColumns& c = series.locos[loco];
+        c.frame.append(frame);
+        c.location.append(loc);
+        c.speed.append(speed);
+        c.mode.append(mode);
+        c.direction.append(dirVal);
+    });
+}
+
+QSharedPointer<const LocoDaySeries> LocoSeriesStore::day(const QString& path)
+{
+    return seriesCache().day(path, fillDay);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/*
+ * Column store for the decoded AAAA12 loco regular packets of a day file.
+ *
+ * Each day is decoded once (GraphBackend::decodeLocoPacket) into one set
+ * of packed columns per loco ID, in file order. Graph queries then
+ * read these columns instead of decoding the packets again; the meta
+ * endpoint uses the smaller DaySummaryCache. Days are cached in a
+ * DayCache (day_cache.h).
+ */
+
+struct LocoColumns
+{
+    QVector<quint32> frame;
+    QVector<quint32> location;
+    QVector<quint16> speed;
+    QVector<quint8>  mode;
+    QVector<quint8>  direction;   // 1 nominal, 2 reverse
+
+    int size() const { return int(frame.size()); }
+};
+
+struct LocoDaySeries
+{
+    QHash<quint32, LocoColumns> locos;
+
+    qint64 memoryCost() const;
+    void squeeze();
+};
+
+class LocoSeriesStore
+{
+public:
+    // Columns of one day file (hex path), decoded on first use. Null when
+    // the file cannot be read.
+    static QSharedPointer<const LocoDaySeries> day(const QString &path);
+
+    // Upper bound for cached days (bytes)
+    static void setCacheBudget(qint64 bytes);
+};
@@ -0,0 +1,246 @@
+#include "log_container.h"
+#include "log_scanner.h"
+#include "hex_decoder.h"
+
+#include <QDate>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+static const char MAGIC[4]  = {'R', 'G', 'S', 'B'};
+static const char FOOTER_MAGIC[4] = {'R', 'G', 'S', 'I'};
+
+// =====================================================
+// PATHS / TIME
+// =====================================================
+
+QString LogContainer::containerPath(const QString& hexPath)
+{
+    if (hexPath.endsWith(".bin", Qt::CaseInsensitive))
+        return hexPath.left(hexPath.size() - 4) + ".rgsb";
+    return hexPath + ".rgsb";
+}
+
+bool LogContainer::isContainer(QByteArrayView data)
+{
+    return data.size() >= HEADER_SIZE + FOOTER_SIZE &&
+           std::memcmp(data.data(), MAGIC, 4) == 0;
+}
+
+quint32 LogContainer::packetTime(const quint8* d, int length, quint8 msgType)
+{
+    // 0x19 carries a 3-byte kavach id, so its date starts one byte later
+    const int at = (msgType == 0x19) ? 13 : 12;
+    if (length < at + 6)
+        return NO_TIME;
+
+    const QDate date(2000 + d[at + 2], d[at + 1], d[at]);
+    if (!date.isValid() || d[at + 3] > 23 || d[at + 4] > 59 || d[at + 5] > 59)
+        return NO_TIME;
+
+    static const QDate epoch(2000, 1, 1);
+    return quint32(epoch.daysTo(date) * 86400 +
+                   d[at + 3] * 3600 + d[at + 4] * 60 + d[at + 5]);
+}
+
+quint32 LogContainer::wallTime(const QDateTime& dt)
+{
+    static const QDate epoch(2000, 1, 1);
+
+    const QDateTime local = dt.toLocalTime();
+    const qint64 secs = epoch.daysTo(local.date()) * 86400 +
+                        local.time().msecsSinceStartOfDay() / 1000;
+
+    return quint32(qBound<qint64>(0, secs, NO_TIME - 1));
+}
+
+// =====================================================
+// WRITER
+// =====================================================
+
+template <typename T>
+static void put(QByteArray& out, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    out.append(b, sizeof(T));
+}
+
+bool LogContainer::convert(const QString& hexPath, const QString& outPath,
+                           QString* error)
+{
+    auto fail = [&](const QString& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    QFile in(hexPath);
+    if (!in.open(QIODevice::ReadOnly))
+        return fail("Cannot open " + hexPath);
+
+    const QByteArray text = in.readAll();
+    const QVector<LogFrame> frames = LogScanner::splitFrames(text);
+
+    QByteArray out;
+    out.reserve(text.size() / 2 + frames.size() * RECORD_HEADER_SIZE);
+    out.append(MAGIC, 4);
+    put<quint16>(out, VERSION);
+    put<quint16>(out, 0);
+
+    QVector<LogBlock> blocks;
+    QByteArray pkt;
+
+    for (const LogFrame& f : frames) {
+
+        if (!HexDecoder::decode(QByteArrayView(text).sliced(f.offset, f.length), pkt) ||
+            pkt.isEmpty() || pkt.size() > 0xFFFF)
+            continue;
+
+        const quint8* d = reinterpret_cast<const quint8*>(pkt.constData());
+        const quint32 t = packetTime(d, int(pkt.size()), f.msgType);
+
+        if (blocks.isEmpty() || blocks.last().records == RECORDS_PER_BLOCK) {
+            LogBlock b;
+            b.offset = out.size();
+            b.minTime = NO_TIME;
+            blocks.append(b);
+        }
+
+        LogBlock& b = blocks.last();
+        b.records++;
+        b.typeMask |= typeBit(f.msgType);
+        if (t != NO_TIME) {
+            b.minTime = qMin(b.minTime, t);
+            b.maxTime = qMax(b.maxTime, t);
+        }
+
+        put<quint16>(out, quint16(pkt.size()));
+        put<quint16>(out, f.sof);
+        put<quint8>(out, f.msgType);
+        put<quint8>(out, 0);
+        put<quint32>(out, t);
+        out.append(pkt);
+    }
+
+    const quint64 indexOffset = quint64(out.size());
+    for (const LogBlock& b : blocks) {
+        put<quint64>(out, quint64(b.offset));
+        put<quint32>(out, b.records);
+        put<quint32>(out, b.typeMask);
+        put<quint32>(out, b.minTime);
+        put<quint32>(out, b.maxTime);
+    }
+
+    put<quint64>(out, indexOffset);
+    put<quint32>(out, quint32(blocks.size()));
+    out.append(FOOTER_MAGIC, 4);
+
+    QSaveFile save(outPath);
+    if (!save.open(QIODevice::WriteOnly))
+        return fail("Cannot create " + outPath);
+
+    if (save.write(out) != out.size() || !save.commit())
+        return fail("Cannot write " + outPath);
+
+    return true;
+}
+
+int LogContainer::convertDir(const QString& dir)
+{
+    QDir d(dir);
+    if (!d.exists())
+        return -1;
+
+    int written = 0;
+    for (const QString& file : d.entryList({"*.bin"}, QDir::Files, QDir::Name)) {
+        const QString hexPath = d.filePath(file);
+        QString error;
+        if (convert(hexPath, containerPath(hexPath), &error))
+            written++;
+        else
+            qWarning().noquote() << error;
+    }
+    return written;
+}
+
+// =====================================================
+// READER
+// =====================================================
+
+bool LogContainer::parse(QByteArrayView data,
+                         QVector<LogFrame>& frames,
+                         QVector<LogBlock>& blocks)
+{
+    frames.clear();
+    blocks.clear();
+
+    if (!isContainer(data))
+        return false;
+
+    const uchar* p = reinterpret_cast<const uchar*>(data.data());
+    const qint64 n = data.size();
+
+    if (qFromLittleEndian<quint16>(p + 4) != VERSION)
+        return false;
+
+    const uchar* foot = p + n - FOOTER_SIZE;
+    if (std::memcmp(foot + 12, FOOTER_MAGIC, 4) != 0)
+        return false;
+
+    const quint64 indexOffset = qFromLittleEndian<quint64>(foot);
+    const quint32 blockCount = qFromLittleEndian<quint32>(foot + 8);
+
+    // Bounds first, so a forged footer can neither wrap the sum below
+    // nor make reserve() allocate for blocks the file cannot hold
+    const quint64 indexEnd = quint64(n - FOOTER_SIZE);
+    if (indexOffset < quint64(HEADER_SIZE) || indexOffset > indexEnd ||
+        blockCount > (indexEnd - indexOffset) / BLOCK_ENTRY_SIZE ||
+        indexOffset + quint64(blockCount) * BLOCK_ENTRY_SIZE != indexEnd)
+        return false;
+
+    blocks.reserve(blockCount);
+    qint64 expected = HEADER_SIZE; // blocks are contiguous
+
+    for (quint32 i = 0; i < blockCount; ++i) {
+        const uchar* e = p + indexOffset + qint64(i) * BLOCK_ENTRY_SIZE;
+
+        LogBlock b;
+        b.offset = qint64(qFromLittleEndian<quint64>(e));
+        b.records = qFromLittleEndian<quint32>(e + 8);
+        b.typeMask = qFromLittleEndian<quint32>(e + 12);
+        b.minTime = qFromLittleEndian<quint32>(e + 16);
+        b.maxTime = qFromLittleEndian<quint32>(e + 20);
+        b.firstFrame = qint32(frames.size());
+
+        if (b.offset != expected)
+            return false;
+
+        qint64 pos = b.offset;
+        for (quint32 r = 0; r < b.records; ++r) {
+            if (pos + RECORD_HEADER_SIZE > qint64(indexOffset))
+                return false;
+
+            const quint16 len = qFromLittleEndian<quint16>(p + pos);
+
+            LogFrame f;
+            f.offset = pos + RECORD_HEADER_SIZE;
+            f.length = len;
+            f.sof = qFromLittleEndian<quint16>(p + pos + 2);
+            f.msgType = p[pos + 4];
+
+            pos = f.offset + len;
+            if (pos > qint64(indexOffset))
+                return false;
+
+            frames.append(f);
+        }
+
+        expected = pos;
+        blocks.append(b);
+    }
+
+    return expected == qint64(indexOffset);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+struct LogFrame;
+
+/*
+ * Compact binary form of a hex-text day log. dd-MM-yy.rgsb sits next to
+ * dd-MM-yy.bin and holds the same frames as raw bytes, so readers skip
+ * both the doubled I/O and the hex decoding.
+ *
+ * Layout (little endian):
+ *   header   "RGSB"  u16 version  u16 reserved
+ *   records  u16 length | u16 sof | u8 msgType | u8 reserved |
+ *            u32 time | length packet bytes (SOF included)
+ *   index    per block: u64 offset | u32 records | u32 typeMask |
+ *            u32 minTime | u32 maxTime
+ *   footer   u64 indexOffset | u32 blockCount | "RGSI"
+ *
+ * time is the packet header time in seconds since 2000-01-01 00:00 on
+ * the log's wall clock (NO_TIME when the header has none). A block holds
+ * up to RECORDS_PER_BLOCK records; typeMask has bit (msgType & 31) set
+ * for every message type present, so readers skip whole blocks.
+ */
+
+struct LogBlock
+{
+    qint64  offset = 0;       // first record header in the file
+    qint32  firstFrame = 0;   // index into the frame table
+    quint32 records = 0;
+    quint32 typeMask = 0;
+    quint32 minTime = 0;
+    quint32 maxTime = 0;
+};
+
+class LogContainer
+{
+public:
+    static constexpr quint32 NO_TIME = 0xFFFFFFFF;
+    static constexpr quint16 VERSION = 1;
+    static constexpr int HEADER_SIZE = 8;
+    static constexpr int RECORD_HEADER_SIZE = 10;
+    static constexpr int BLOCK_ENTRY_SIZE = 24;
+    static constexpr int FOOTER_SIZE = 16;
+    static constexpr int RECORDS_PER_BLOCK = 1024;
+
+    static quint32 typeBit(quint8 msgType) { return 1u << (msgType & 31); }
+
+    // dd-MM-yy.bin -> dd-MM-yy.rgsb
+    static QString containerPath(const QString& hexPath);
+
+    // True when 'data' starts with the container magic.
+    static bool isContainer(QByteArrayView data);
+
+    // Header time of a decoded packet (see above).
+    static quint32 packetTime(const quint8* d, int length, quint8 msgType);
+
+    // Same scale for a query bound (taken on the local wall clock).
+    static quint32 wallTime(const QDateTime& dt);
+
+    // Convert one hex day file. Written atomically; false on I/O errors.
+    static bool convert(const QString& hexPath, const QString& outPath,
+                        QString* error = nullptr);
+
+    // Convert every *.bin in a directory. Returns the number written,
+    // or -1 if the directory cannot be read.
+    static int convertDir(const QString& dir);
+
+    // Validate a container and build its frame table (offsets/lengths in
+    // bytes of packet data) and block index. False if it is malformed.
+    static bool parse(QByteArrayView data,
+                      QVector<LogFrame>& frames,
+                      QVector<LogBlock>& blocks);
+};
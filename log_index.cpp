@@ -0,0 +1,350 @@
+#include "log_index.h"
+#include "bit_reader.h"
+#include "hex_decoder.h"
+#include "kavach_schema.h"
+
+#include <QDateTime>
+#include <QMap>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+static const char MAGIC[4] = {'R', 'G', 'I', 'X'};
+
+static const int HEADER_SIZE = 32;
+static const int FRAME_SIZE = 16;
+static const int KEY_SIZE = 12;
+
+// Files this recent are still being appended to
+static const int SETTLE_SECS = 60;
+
+template <typename T>
+static void put(QByteArray& out, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    out.append(b, sizeof(T));
+}
+
+template <typename T>
+static T get(const uchar* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+QString LogIndex::indexPath(const QString& hexPath)
+{
+    if (hexPath.endsWith(".bin", Qt::CaseInsensitive))
+        return hexPath.left(hexPath.size() - 4) + ".idx";
+    return hexPath + ".idx";
+}
+
+// =====================================================
+// KEYS
+// =====================================================
+
+void LogIndex::packetKeys(const quint8* d, int length, quint8 msgType,
+                          quint32& station, quint32& loco, quint32& minute)
+{
+    station = NO_KEY;
+    loco = NO_KEY;
+    minute = NO_KEY;
+
+    // 0x19 carries a 3-byte kavach id
+    if (msgType == 0x19) {
+        if (length >= 10)
+            station = (quint32(d[7]) << 16) | (d[8] << 8) | d[9];
+    }
+    else if (length >= 9) {
+        station = (quint32(d[7]) << 8) | d[8];
+    }
+
+    const quint32 t = LogContainer::packetTime(d, length, msgType);
+    if (t != LogContainer::NO_TIME)
+        minute = t / 60;
+
+    if (msgType == 0x12) {
+        // Radio packet right after A5 C3 at bytes 19..20; regular (1010)
+        // and access (1101) both carry SourceLocoId at bits 28..47
+        const void* a5 = std::memchr(d, 0xA5, size_t(length));
+        if (a5 == d + 19 && length > 27 && d[20] == 0xC3) {
+            const int type = d[21] >> 4;
+            if (type == 0xA || type == 0xD)
+                loco = quint32(BitReader::extract(d + 21, length - 21, 28, 20));
+        }
+    }
+    else if (msgType == 0x11) {
+        // Regular (1001) payload after the first A5 C3: DEST_LOCO_ID
+        for (int i = 0; i + 2 < length; ++i) {
+            if (d[i] != 0xA5 || d[i + 1] != 0xC3)
+                continue;
+
+            const quint8* p = d + i + 2;
+            const qint64 n = length - i - 2;
+            if ((p[0] >> 4) == 0b1001)
+                loco = quint32(KavachSchema::project(p, n, KavachSchema::REGULAR_DEST_LOCO_ID));
+            break;
+        }
+    }
+}
+
+// =====================================================
+// BUILD
+// =====================================================
+
+QByteArray LogIndex::build(const LogDay& day)
+{
+    QMap<quint32, QVector<quint32>> sections[SectionCount];
+
+    QByteArray out;
+    out.reserve(HEADER_SIZE + day.frames.size() * (FRAME_SIZE + 4 * SectionCount));
+    out.append(MAGIC, 4);
+    put<quint16>(out, VERSION);
+    put<quint16>(out, day.binary ? 1 : 0);
+    put<qint64>(out, day.fileSize);
+    put<qint64>(out, day.modified.toMSecsSinceEpoch());
+    put<quint32>(out, quint32(day.frames.size()));
+    put<quint32>(out, 0);
+
+    const quint8* base = reinterpret_cast<const quint8*>(day.file.data.data());
+    QByteArray buffer;
+
+    for (int n = 0; n < day.frames.size(); ++n) {
+        const LogFrame& f = day.frames.at(n);
+
+        put<quint64>(out, quint64(f.offset));
+        put<quint32>(out, quint32(f.length));
+        put<quint16>(out, f.sof);
+        put<quint8>(out, f.msgType);
+        put<quint8>(out, 0);
+
+        const quint8* d = base + f.offset;
+        int length = f.length;
+
+        if (!day.binary) {
+            if (!HexDecoder::decode(day.file.data.sliced(f.offset, f.length), buffer))
+                buffer.clear();
+            d = reinterpret_cast<const quint8*>(buffer.constData());
+            length = int(buffer.size());
+        }
+
+        quint32 station, loco, minute;
+        packetKeys(d, length, f.msgType, station, loco, minute);
+
+        sections[ByType][LogScanner::frameKey(f.sof, f.msgType)].append(quint32(n));
+        sections[ByStation][station].append(quint32(n));
+        sections[ByLoco][loco].append(quint32(n));
+        sections[ByMinute][minute].append(quint32(n));
+    }
+
+    for (const auto& section : sections) {
+        put<quint32>(out, quint32(section.size()));
+
+        quint32 first = 0;
+        for (auto it = section.cbegin(); it != section.cend(); ++it) {
+            put<quint32>(out, it.key());
+            put<quint32>(out, first);
+            put<quint32>(out, quint32(it.value().size()));
+            first += quint32(it.value().size());
+        }
+
+        put<quint32>(out, first);
+        for (const QVector<quint32>& frames : section)
+            for (quint32 n : frames)
+                put<quint32>(out, n);
+    }
+
+    return out;
+}
+
+// =====================================================
+// OPEN
+// =====================================================
+
+bool LogIndex::attach(QByteArrayView data)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(data.data());
+    const qint64 size = data.size();
+
+    if (size < HEADER_SIZE || std::memcmp(p, MAGIC, 4) != 0 ||
+        get<quint16>(p + 4) != VERSION)
+        return false;
+
+    m_frameCount = get<quint32>(p + 24);
+
+    qint64 pos = HEADER_SIZE;
+    m_frames = p + pos;
+    pos += qint64(m_frameCount) * FRAME_SIZE;
+
+    for (int s = 0; s < SectionCount; ++s) {
+        if (pos + 4 > size)
+            return false;
+
+        m_keyCount[s] = get<quint32>(p + pos);
+        m_keys[s] = p + pos + 4;
+        pos += 4 + qint64(m_keyCount[s]) * KEY_SIZE;
+
+        if (pos + 4 > size)
+            return false;
+
+        const quint32 postings = get<quint32>(p + pos);
+        m_postings[s] = p + pos + 4;
+        pos += 4 + qint64(postings) * 4;
+
+        if (pos > size)
+            return false;
+
+        for (quint32 k = 0; k < m_keyCount[s]; ++k) {
+            const uchar* e = m_keys[s] + k * KEY_SIZE;
+            if (quint64(get<quint32>(e + 4)) + get<quint32>(e + 8) > postings)
+                return false;
+        }
+    }
+
+    return pos == size;
+}
+
+QSharedPointer<const LogIndex> LogIndex::open(const QString& hexPath)
+{
+    QFileInfo src;
+    bool binary;
+    if (!LogScanner::daySource(hexPath, src, binary))
+        return {};
+
+    if (src.lastModified().secsTo(QDateTime::currentDateTime()) < SETTLE_SECS)
+        return {};
+
+    const QString path = indexPath(hexPath);
+    QSharedPointer<LogIndex> index(new LogIndex);
+
+    if (index->m_file.open(path, false) && index->attach(index->m_file.data)) {
+        const uchar* p = reinterpret_cast<const uchar*>(index->m_file.data.data());
+
+        const bool fresh =
+            bool(get<quint16>(p + 6) & 1) == binary &&
+            get<qint64>(p + 8) == src.size() &&
+            get<qint64>(p + 16) == src.lastModified().toMSecsSinceEpoch();
+
+        if (fresh && index->m_source.open(src.filePath(), false)) {
+            index->m_binary = binary;
+            return index;
+        }
+    }
+
+    // (Re)build from one full read of the day
+    QSharedPointer<const LogDay> day = LogScanner::loadDay(hexPath);
+    if (!day)
+        return {};
+
+    index.reset(new LogIndex);
+    index->m_file.owned = build(*day);
+    index->m_file.data = index->m_file.owned;
+    index->m_source = day->file;  // shares the day's mapping
+    index->m_binary = day->binary;
+
+    if (!index->attach(index->m_file.data))
+        return {};
+
+    // A read-only log directory only costs the on-disk copy
+    QSaveFile save(path);
+    if (save.open(QIODevice::WriteOnly) &&
+        save.write(index->m_file.owned) == index->m_file.owned.size())
+        save.commit();
+
+    return index;
+}
+
+// =====================================================
+// LOOKUP
+// =====================================================
+
+LogFrame LogIndex::frame(quint32 n) const
+{
+    LogFrame f;
+    if (n >= m_frameCount)
+        return f;
+
+    const uchar* e = m_frames + qint64(n) * FRAME_SIZE;
+    f.offset = qint64(get<quint64>(e));
+    f.length = qint32(get<quint32>(e + 8));
+    f.sof = get<quint16>(e + 12);
+    f.msgType = e[14];
+    return f;
+}
+
+QVector<quint32> LogIndex::postings(Section s, quint32 fromKey, quint32 toKey,
+                                    bool withUnknown) const
+{
+    QVector<quint32> out;
+    const uchar* keys = m_keys[s];
+    const quint32 count = m_keyCount[s];
+
+    // Keys are sorted; find the first >= fromKey
+    quint32 lo = 0, hi = count;
+    while (lo < hi) {
+        const quint32 mid = (lo + hi) / 2;
+        if (get<quint32>(keys + mid * KEY_SIZE) < fromKey)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    int lists = 0;
+    auto append = [&](const uchar* e) {
+        const quint32 first = get<quint32>(e + 4);
+        const quint32 n = get<quint32>(e + 8);
+        for (quint32 i = 0; i < n; ++i)
+            out.append(get<quint32>(m_postings[s] + qint64(first + i) * 4));
+        lists++;
+    };
+
+    for (quint32 k = lo; k < count; ++k) {
+        const uchar* e = keys + k * KEY_SIZE;
+        const quint32 key = get<quint32>(e);
+        if (key > toKey || key == NO_KEY)
+            break;
+        append(e);
+    }
+
+    if (withUnknown && count > 0) {
+        const uchar* last = keys + (count - 1) * KEY_SIZE;
+        if (get<quint32>(last) == NO_KEY)
+            append(last);
+    }
+
+    if (lists > 1)
+        std::sort(out.begin(), out.end());
+    return out;
+}
+
+QVector<quint32> LogIndex::select(const QVector<quint32>& typeKeys,
+                                  const LogQuery& query) const
+{
+    QVector<quint32> result;
+    for (quint32 key : typeKeys)
+        result += postings(ByType, key, key, false);
+    std::sort(result.begin(), result.end());
+
+    auto narrow = [&](Section s, quint32 fromKey, quint32 toKey) {
+        const QVector<quint32> hits = postings(s, fromKey, toKey, true);
+        QVector<quint32> out;
+        std::set_intersection(result.cbegin(), result.cend(),
+                              hits.cbegin(), hits.cend(),
+                              std::back_inserter(out));
+        result.swap(out);
+    };
+
+    if (query.station != LogQuery::ANY)
+        narrow(ByStation, query.station, query.station);
+
+    if (query.loco != LogQuery::ANY)
+        narrow(ByLoco, query.loco, query.loco);
+
+    if (query.fromTime != 0 || query.toTime != LogQuery::ANY)
+        narrow(ByMinute, query.fromTime / 60,
+               query.toTime == LogQuery::ANY ? NO_KEY - 1 : query.toTime / 60);
+
+    return result;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "log_scanner.h"
+
+/*
+ * Sidecar index of a day log (dd-MM-yy.idx next to dd-MM-yy.bin).
+ *
+ * Holds the frame table of the day file plus four posting lists of frame
+ * numbers: by (SOF, message type), stationary kavach id, loco id and
+ * minute bucket. With it, a query for one loco or one station maps the
+ * day file and touches only the matching packets, instead of splitting
+ * and decoding the whole file.
+ *
+ * The index describes whatever file LogScanner::daySource() reads
+ * (container or hex) and records its size + mtime. It is built lazily on
+ * the first filtered read and rebuilt when either changes. Files written
+ * to within the last minute are not indexed; they are still growing and
+ * a plain scan is cheaper than a rebuild per query.
+ *
+ * Layout (little endian):
+ *   header   "RGIX"  u16 version  u16 flags (1 = container source)
+ *            i64 sourceSize  i64 sourceMtime (ms)  u32 frames  u32 0
+ *   frames   u64 offset | u32 length | u16 sof | u8 msgType | u8 0
+ *   4 x      u32 keys | keys x (u32 key, u32 first, u32 count) |
+ *            u32 postings | postings x u32 frame number
+ *            (sections: type, station, loco, minute)
+ *
+ * Keys that cannot be read from a packet are stored as NO_KEY and match
+ * every query.
+ */
+
+class LogIndex
+{
+public:
+    static constexpr quint32 NO_KEY = 0xFFFFFFFF;
+    static constexpr quint16 VERSION = 1;
+
+    enum Section { ByType, ByStation, ByLoco, ByMinute, SectionCount };
+
+    // dd-MM-yy.bin -> dd-MM-yy.idx
+    static QString indexPath(const QString& hexPath);
+
+    // Index for a day file, reading or (re)building it as needed.
+    // Null when the day file is missing or still being written.
+    static QSharedPointer<const LogIndex> open(const QString& hexPath);
+
+    // Serialize the index of a loaded day.
+    static QByteArray build(const LogDay& day);
+
+    // Station / loco / minute keys of one decoded packet.
+    static void packetKeys(const quint8* d, int length, quint8 msgType,
+                           quint32& station, quint32& loco, quint32& minute);
+
+    // Frame numbers (ascending) matching any of 'typeKeys' and 'query'.
+    QVector<quint32> select(const QVector<quint32>& typeKeys,
+                            const LogQuery& query) const;
+
+    LogFrame frame(quint32 n) const;
+
+    QByteArrayView source() const { return m_source.data; }
+    bool binary() const { return m_binary; }
+
+private:
+    struct Posting { quint32 key, first, count; };
+
+    bool attach(QByteArrayView data);
+    QVector<quint32> postings(Section s, quint32 fromKey, quint32 toKey,
+                              bool withUnknown) const;
+
+    MappedFile m_source;      // day file the frames point into
+    MappedFile m_file;        // index bytes (mapped or freshly built)
+    bool m_binary = false;
+
+    quint32 m_frameCount = 0;
+    const uchar* m_frames = nullptr;
+    const uchar* m_keys[SectionCount] = {};
+    quint32 m_keyCount[SectionCount] = {};
+    const uchar* m_postings[SectionCount] = {};
+};
@@ -0,0 +1,729 @@
+#include "log_ingest.h"
+#include "db_pool.h"
+#include "fault_rollup.h"
+#include "log_parallel.h"
+#include "log_scanner.h"
+#include "lvk_fault_parser.h"
+#include "lvk_pos_info_parser.h"
+#include "lvk_pos_info_view.h"
+#include "stations_config.h"
+
+#include <QDate>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <memory>
+#include <stdexcept>
+
+#define JNUM(x) QJsonValue(static_cast<qint64>(x))
+
+// =====================================================
+// TABLES
+// =====================================================
+
+const QStringList &LogIngest::columns(IngestBatch::Table table)
+{
+    static const QStringList movement = {
+        "event_time", "station_code", "stationary_kavach_id", "packet_type",
+        "loco_id", "frame_number", "absolute_loco_location", "train_speed_kmph",
+        "movement_direction", "loco_mode", "emergency_status", "data_source"
+    };
+    static const QStringList fault = {
+        "event_time", "station_code", "fault_origin", "kavach_subsystem_id",
+        "nms_system_id", "subsystem_type", "fault_module_id", "fault_type",
+        "fault_code", "data_source"
+    };
+    return table == IngestBatch::Movement ? movement : fault;
+}
+
+QString LogIngest::tableName(IngestBatch::Table table)
+{
+    return table == IngestBatch::Movement ? "loco_movement_logs" : "loco_fault_logs";
+}
+
+bool LogIngest::createTables(QSqlDatabase &db, QString &error)
+{
+    const bool sqlite = db.driverName() == "QSQLITE";
+
+    const QString movement =
+        "event_time DATETIME NOT NULL,"
+        "station_code VARCHAR(16),"
+        "stationary_kavach_id INT,"
+        "packet_type INT,"
+        "loco_id INT,"
+        "frame_number INT,"
+        "absolute_loco_location INT,"
+        "train_speed_kmph INT,"
+        "movement_direction INT,"
+        "loco_mode INT,"
+        "emergency_status INT,"
+        "data_source VARCHAR(16),";
+
+    const QString fault =
+        "event_time DATETIME NOT NULL,"
+        "station_code VARCHAR(16),"
+        "fault_origin VARCHAR(16),"
+        "kavach_subsystem_id INT,"
+        "nms_system_id INT,"
+        "subsystem_type VARCHAR(8),"
+        "fault_module_id VARCHAR(8),"
+        "fault_type VARCHAR(16),"
+        "fault_code VARCHAR(8),"
+        "data_source VARCHAR(16),";
+
+    for (IngestBatch::Table t : {IngestBatch::Movement, IngestBatch::Fault}) {
+        const QString name = tableName(t);
+        const QString body = t == IngestBatch::Movement ? movement : fault;
+
+        const QString sql = sqlite
+            ? QString("CREATE TABLE IF NOT EXISTS %1 ("
+                      "id INTEGER PRIMARY KEY AUTOINCREMENT,%2"
+                      "created_at DATETIME DEFAULT CURRENT_TIMESTAMP)").arg(name, body)
+            : QString("IF OBJECT_ID('%1', 'U') IS NULL CREATE TABLE %1 ("
+                      "id BIGINT IDENTITY(1,1) PRIMARY KEY,%2"
+                      "created_at DATETIME DEFAULT GETDATE())").arg(name, body);
+
+        QSqlQuery q(db);
+        if (!q.exec(sql)) {
+            error = q.lastError().text();
+            return false;
+        }
+    }
+
+    // Committed rows per day file
+    const QString progress =
+        "log_file VARCHAR(400) NOT NULL PRIMARY KEY,"
+        "movement_rows BIGINT NOT NULL,"
+        "fault_rows BIGINT NOT NULL";
+
+    QSqlQuery q(db);
+    if (!q.exec(sqlite
+            ? QString("CREATE TABLE IF NOT EXISTS log_ingest_days (%1)").arg(progress)
+            : QString("IF OBJECT_ID('log_ingest_days', 'U') IS NULL "
+                      "CREATE TABLE log_ingest_days (%1)").arg(progress))) {
+        error = q.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool LogIngest::readProgress(QSqlDatabase &db,
+                             QHash<QString, QPair<qint64, qint64>> &progress,
+                             QString &error)
+{
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (!q.exec("SELECT log_file, movement_rows, fault_rows FROM log_ingest_days")) {
+        error = q.lastError().text();
+        return false;
+    }
+
+    while (q.next())
+        progress.insert(q.value(0).toString(),
+                        qMakePair(q.value(1).toLongLong(), q.value(2).toLongLong()));
+    return true;
+}
+
+// Only the writer of the one running ingest touches the table, so a
+// plain update-or-insert cannot race
+bool LogIngest::writeProgress(QSqlDatabase &db, const IngestBatch &batch,
+                              QSqlError &error)
+{
+    const bool movement = batch.table == IngestBatch::Movement;
+    const qint64 rows = batch.firstRow + batch.rows;
+
+    QSqlQuery update(db);
+    update.prepare(QString("UPDATE log_ingest_days SET %1 = ? WHERE log_file = ?")
+                       .arg(movement ? "movement_rows" : "fault_rows"));
+    update.addBindValue(rows);
+    update.addBindValue(batch.file);
+
+    if (!update.exec()) {
+        error = update.lastError();
+        return false;
+    }
+    if (update.numRowsAffected() > 0)
+        return true;
+
+    QSqlQuery insert(db);
+    insert.prepare("INSERT INTO log_ingest_days (log_file, movement_rows, fault_rows) "
+                   "VALUES (?, ?, ?)");
+    insert.addBindValue(batch.file);
+    insert.addBindValue(movement ? rows : 0);
+    insert.addBindValue(movement ? 0 : rows);
+
+    if (!insert.exec()) {
+        error = insert.lastError();
+        return false;
+    }
+    return true;
+}
+
+static QString insertSql(IngestBatch::Table table, int rows)
+{
+    const QStringList &cols = LogIngest::columns(table);
+
+    QString tuple = "(?";
+    for (int c = 1; c < cols.size(); ++c)
+        tuple += ",?";
+    tuple += ")";
+
+    QString sql = QString("INSERT INTO %1 (%2) VALUES ")
+                      .arg(LogIngest::tableName(table), cols.join(','));
+    for (int r = 0; r < rows; ++r) {
+        if (r > 0)
+            sql += ',';
+        sql += tuple;
+    }
+    return sql;
+}
+
+// =====================================================
+// PIPELINE
+// =====================================================
+
+LogIngest::LogIngest(const Options &options)
+    : m_options(options)
+{
+    m_options.batchRows = qMax(1, m_options.batchRows);
+    m_options.maxPending = qMax(1, m_options.maxPending);
+    m_options.maxRetries = qMax(0, m_options.maxRetries);
+
+    m_clock.start();
+
+    m_writer = QThread::create([this] { writerLoop(); });
+    m_writer->start();
+}
+
+LogIngest::~LogIngest()
+{
+    finish();
+}
+
+bool LogIngest::failed() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_failed;
+}
+
+bool LogIngest::committedRows(const QString &file, qint64 &movement, qint64 &fault)
+{
+    QMutexLocker lock(&m_mutex);
+    while (!m_ready && !m_failed)
+        m_started.wait(&m_mutex);
+
+    if (m_failed)
+        return false;
+
+    const QPair<qint64, qint64> rows = m_progress.value(file);
+    movement = rows.first;
+    fault = rows.second;
+    return true;
+}
+
+// Producers block on the writer; kept apart from LogParallel::pool() so
+// a slow server never stalls the report scans
+static QThreadPool *ingestPool()
+{
+    static QThreadPool *p = [] {
+        auto *tp = new QThreadPool;
+        tp->setMaxThreadCount(QThread::idealThreadCount());
+        return tp;
+    }();
+    return p;
+}
+
+QJsonObject LogIngest::ingestByDateRange(const QString &logDir,
+                                         const QString &fromDate,
+                                         const QString &toDate)
+{
+    const QDate from = QDate::fromString(fromDate.left(10), "yyyy-MM-dd");
+    const QDate to   = QDate::fromString(toDate.left(10), "yyyy-MM-dd");
+
+    if (!from.isValid() || !to.isValid() || from > to)
+        return {{"success", false}, {"error", "Invalid date range"}};
+
+    if (!QDir(logDir).exists())
+        return {{"success", false}, {"error", "Log directory not found"}};
+
+    const QStringList paths = LogParallel::dayPaths(logDir, from, to);
+
+    // Progress records assume a single writer
+    static QMutex running;
+    if (!running.tryLock())
+        return {{"success", false}, {"error", "An ingest is already running"}};
+
+    QJsonObject res;
+    {
+        LogIngest ingest;
+        ingest.ingestDays(paths);
+        res = ingest.finish();
+    }
+    running.unlock();
+
+    res["days"] = int(paths.size());
+    return res;
+}
+
+void LogIngest::ingestDays(const QStringList &paths)
+{
+    QStringList files = paths;
+
+    QtConcurrent::blockingMap(ingestPool(), files, [this](const QString &path) {
+        const QString file = QFileInfo(path).absoluteFilePath();
+
+        qint64 movement, fault;
+        if (!committedRows(file, movement, fault))
+            return;
+
+        IngestBatcher batcher(*this, file, movement, fault);
+
+        LogScanner scanner;
+        scanner.on(0x12, [&](const LogPacket &pkt) { batcher.addPosInfo(pkt); })
+               .on(LogScanner::SOF_AAAA, 0x19, [&](const LogPacket &pkt) { batcher.addFault(pkt); })
+               .on(LogScanner::SOF_BBBB, 0x19, [&](const LogPacket &pkt) { batcher.addFault(pkt); });
+        scanner.scanFile(path);
+
+        batcher.flush();
+
+        QMutexLocker lock(&m_mutex);
+        m_rowsSkipped += batcher.skipped();
+        m_crcRejected += batcher.crcRejected();
+    });
+}
+
+void LogIngest::push(IngestBatch batch)
+{
+    if (batch.rows == 0)
+        return;
+
+    QMutexLocker lock(&m_mutex);
+
+    // Backpressure: wait for the writer
+    if (m_queue.size() >= m_options.maxPending && !m_failed) {
+        m_producerWaits++;
+        while (m_queue.size() >= m_options.maxPending && !m_failed)
+            m_drained.wait(&m_mutex);
+    }
+
+    if (m_failed || m_finishing) {
+        m_rowsFailed += batch.rows;
+        return;
+    }
+
+    m_rowsQueued += batch.rows;
+    m_queue.enqueue(std::move(batch));
+    m_queued.wakeOne();
+}
+
+QJsonObject LogIngest::finish()
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (!m_finished) {
+        m_finishing = true;
+        m_queued.wakeAll();
+        lock.unlock();
+
+        m_writer->wait();
+        delete m_writer;
+        m_writer = nullptr;
+
+        lock.relock();
+        m_finished = true;
+        m_elapsedMs = m_clock.elapsed();
+    }
+
+    QJsonObject res{
+        {"success", !m_failed && m_rowsFailed == 0},
+        {"rowsQueued", JNUM(m_rowsQueued)},
+        {"rowsWritten", JNUM(m_rowsWritten)},
+        {"rowsFailed", JNUM(m_rowsFailed)},
+        {"rowsSkipped", JNUM(m_rowsSkipped)},
+        {"crcRejected", JNUM(m_crcRejected)},
+        {"batches", JNUM(m_batches)},
+        {"retries", JNUM(m_retries)},
+        {"producerWaits", JNUM(m_producerWaits)},
+        {"writeMs", JNUM(m_writeMs)},
+        {"elapsedMs", JNUM(m_elapsedMs)},
+        {"rowsPerSecond", JNUM(m_elapsedMs > 0 ? m_rowsWritten * 1000 / m_elapsedMs : 0)}
+    };
+    if (!m_lastError.isEmpty())
+        res["error"] = m_lastError;
+    return res;
+}
+
+// =====================================================
+// WRITER
+// =====================================================
+
+void LogIngest::writerLoop()
+{
+    const QString cloneName =
+        QStringLiteral("rgs_ingest_%1").arg(quintptr(this), 0, 16);
+    {
+        std::unique_ptr<DbConnection> lease;
+        QSqlDatabase db;
+        QString error;
+
+        if (m_options.connection.isEmpty()) {
+            lease.reset(new DbConnection);
+            if (lease->isValid())
+                db = lease->database();
+            else
+                error = lease->error();
+        } else {
+            db = QSqlDatabase::cloneDatabase(m_options.connection, cloneName);
+            if (!db.open())
+                error = db.lastError().text();
+        }
+
+        QHash<QString, QPair<qint64, qint64>> progress;
+        const bool ready = error.isEmpty() && createTables(db, error) &&
+                           FaultRollup::ensureTable(db, error) &&
+                           readProgress(db, progress, error);
+        {
+            QMutexLocker lock(&m_mutex);
+            if (ready) {
+                m_progress = progress;
+                m_ready = true;
+            } else {
+                m_failed = true;
+                m_lastError = error;
+                m_drained.wakeAll();
+            }
+            m_started.wakeAll();
+        }
+
+        QHash<quint64, QSqlQuery> statements;
+
+        // File + table of a failed batch: later batches of it are dropped
+        // too, so its committed rows never skip over a gap
+        QSet<QString> broken;
+
+        for (;;) {
+            IngestBatch batch;
+            {
+                QMutexLocker lock(&m_mutex);
+                while (m_queue.isEmpty() && !m_finishing)
+                    m_queued.wait(&m_mutex);
+                if (m_queue.isEmpty())
+                    break;
+
+                batch = m_queue.dequeue();
+                m_drained.wakeAll();
+            }
+
+            const QString stream = batch.file + '|' + QString::number(batch.table);
+            if (!ready || broken.contains(stream)) {
+                QMutexLocker lock(&m_mutex);
+                m_rowsFailed += batch.rows;
+                continue;
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+
+            bool ok = false;
+            QSqlError sqlError;
+            for (int attempt = 0; ; ++attempt) {
+                if (writeBatch(db, statements, batch, sqlError)) {
+                    ok = true;
+                    break;
+                }
+                if (attempt >= m_options.maxRetries)
+                    break;
+
+                {
+                    QMutexLocker lock(&m_mutex);
+                    m_retries++;
+                }
+                QThread::msleep(RETRY_BASE_MS << attempt);
+
+                // Dropped connection: statements die with it
+                if (sqlError.type() == QSqlError::ConnectionError || !db.isOpen()) {
+                    statements.clear();
+                    if (lease) {
+                        // Give the pool connection back closed, lease anew
+                        db = QSqlDatabase();
+                        lease->discard();
+                        lease.reset();
+                        lease.reset(new DbConnection);
+                        if (lease->isValid())
+                            db = lease->database();
+                    } else {
+                        db.close();
+                        db.open();
+                    }
+                }
+            }
+
+            QMutexLocker lock(&m_mutex);
+            m_writeMs += timer.elapsed();
+            m_batches++;
+            if (ok) {
+                m_rowsWritten += batch.rows;
+            } else {
+                broken.insert(stream);
+                m_rowsFailed += batch.rows;
+                m_lastError = sqlError.text();
+            }
+        }
+
+        statements.clear();
+        db = QSqlDatabase();
+    }
+
+    if (!m_options.connection.isEmpty())
+        QSqlDatabase::removeDatabase(cloneName);
+}
+
+bool LogIngest::writeBatch(QSqlDatabase &db, QHash<quint64, QSqlQuery> &statements,
+                           const IngestBatch &batch, QSqlError &error)
+{
+    const int width = int(columns(batch.table).size());
+    const int perStatement = qMin(MAX_INSERT_ROWS, MAX_INSERT_PARAMS / width);
+
+    if (!db.transaction()) {
+        error = db.lastError();
+        return false;
+    }
+
+    for (int row = 0; row < batch.rows; ) {
+        const int n = qMin(perStatement, batch.rows - row);
+
+        // Full statements share one prepared INSERT; the tail gets its own
+        const quint64 key = (quint64(batch.table) << 32) | quint32(n);
+        auto it = statements.find(key);
+        if (it == statements.end()) {
+            QSqlQuery q(db);
+            if (!q.prepare(insertSql(batch.table, n))) {
+                error = q.lastError();
+                db.rollback();
+                return false;
+            }
+            it = statements.emplace(key, std::move(q));
+        }
+
+        QSqlQuery &q = it.value();
+        const qsizetype base = qsizetype(row) * width;
+        for (int i = 0; i < n * width; ++i)
+            q.bindValue(i, batch.values.at(base + i));
+
+        const bool ok = q.exec();
+        if (!ok)
+            error = q.lastError();
+        q.finish();
+
+        if (!ok) {
+            db.rollback();
+            return false;
+        }
+        row += n;
+    }
+
+    // Fault rows count into the summary rollup in the same transaction
+    if (batch.table == IngestBatch::Fault) {
+        FaultRollupDelta delta;
+        for (int row = 0; row < batch.rows; ++row) {
+            const qsizetype base = qsizetype(row) * width;
+            delta.add(batch.values.at(base + 1).toString(),        // station_code
+                      batch.values.at(base).toDateTime().date());  // event_time
+        }
+
+        if (!FaultRollup::apply(db, FaultRollup::Loco, delta, error)) {
+            db.rollback();
+            return false;
+        }
+    }
+
+    // The file's committed rows move on with the rows themselves
+    if (!writeProgress(db, batch, error)) {
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        error = db.lastError();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+// =====================================================
+// BATCHER
+// =====================================================
+
+IngestBatcher::IngestBatcher(LogIngest &ingest, const QString &file,
+                             qint64 movementCommitted, qint64 faultCommitted)
+    : m_ingest(ingest)
+{
+    m_movement.table = IngestBatch::Movement;
+    m_movement.file = file;
+    m_fault.table = IngestBatch::Fault;
+    m_fault.file = file;
+
+    m_committed[IngestBatch::Movement] = movementCommitted;
+    m_committed[IngestBatch::Fault] = faultCommitted;
+}
+
+IngestBatcher::~IngestBatcher()
+{
+    flush();
+}
+
+QVariant IngestBatcher::stationCode(int stationId)
+{
+    auto it = m_stationCodes.constFind(stationId);
+    if (it != m_stationCodes.constEnd())
+        return it.value();
+
+    StationInfo s;
+    const QVariant code = getStationById(stationId, s)
+        ? QVariant(s.station_code)
+        : QVariant(QMetaType::fromType<QString>());
+
+    m_stationCodes.insert(stationId, code);
+    return code;
+}
+
+void IngestBatcher::addPosInfo(const LogPacket &pkt)
+{
+    const LVKPosInfoView view(pkt.data, pkt.length);
+    if (!view.isValid() || view.wallSeconds() < 0)
+        return;
+
+    quint32 frame, loco, location, speed;
+    quint8 direction, mode, emergency;
+
+    const int type = view.packetType();
+    try {
+        if (type == 0xA) {
+            OnboardRegularPacketModel m;
+            LVKPosInfoParser::decodeRegular(view, m);
+            frame = m.FrameNumber; loco = m.SourceLocoId;
+            location = m.AbsoluteLocoLocation; speed = m.TrainSpeed;
+            direction = m.MovementDir; mode = m.LocoMode; emergency = m.EmergencyStatus;
+        } else if (type == 0xD) {
+            OnboardAccessRequestPacketModel a;
+            LVKPosInfoParser::decodeAccessRequest(view, a);
+            frame = a.FrameNumber; loco = a.SourceLocoId;
+            location = a.AbsoluteLocoLocation; speed = a.TrainSpeed;
+            direction = a.MovementDir; mode = a.LocoMode; emergency = a.EmergencyStatus;
+        } else {
+            return;
+        }
+    } catch (...) {
+        return;
+    }
+
+    if (!wanted(m_movement))
+        return;
+
+    QVariantList &v = m_movement.values;
+    v << view.dateTime()
+      << stationCode(view.stationaryKavachId())
+      << int(view.stationaryKavachId())
+      << type
+      << qint64(loco)
+      << qint64(frame)
+      << qint64(location)
+      << qint64(speed)
+      << int(direction)
+      << int(mode)
+      << int(emergency)
+      << QStringLiteral("BIN");
+
+    add(m_movement);
+}
+
+void IngestBatcher::addFault(const LogPacket &pkt)
+{
+    if (!LVKFaultParser::crcOk(pkt.data, pkt.length)) {
+        m_crcRejected++;
+        return;
+    }
+
+    LVKFaultPacket f;
+    try {
+        f = LVKFaultParser::parse(pkt.data, pkt.length, false);
+    } catch (...) {
+        return;
+    }
+
+    const bool isStation = f.startOfFrame == LogScanner::SOF_AAAA;
+    const QVariant station = isStation
+        ? stationCode(int(f.kavachSubsystemId))
+        : QVariant(QMetaType::fromType<QString>());
+
+    const QString subsystem =
+        QString("%1").arg(uint(f.subsystemType), 2, 16, QChar('0')).toUpper();
+
+    for (const LVKFaultItem &item : f.faults) {
+        if (!wanted(m_fault))
+            continue;
+
+        QVariantList &v = m_fault.values;
+        v << f.packetDateTime
+          << station
+          << QString(isStation ? "STATION" : "LOCO")
+          << qint64(f.kavachSubsystemId)
+          << int(f.nmsSystemId)
+          << subsystem
+          << QString("%1").arg(uint(item.moduleId), 2, 16, QChar('0')).toUpper()
+          << QString(item.codeType == FaultCodeType::FAULT ? "FAULT" : "RECOVERY")
+          << QString("%1").arg(uint(item.faultCode), 4, 16, QChar('0')).toUpper()
+          << QStringLiteral("BIN");
+
+        add(m_fault);
+    }
+}
+
+bool IngestBatcher::wanted(IngestBatch &batch)
+{
+    const qint64 index = m_next[batch.table]++;
+    if (index < m_committed[batch.table]) {
+        m_skipped++;
+        return false;
+    }
+
+    if (batch.rows == 0)
+        batch.firstRow = index;
+    return true;
+}
+
+void IngestBatcher::add(IngestBatch &batch)
+{
+    if (++batch.rows < m_ingest.options().batchRows)
+        return;
+
+    const IngestBatch::Table table = batch.table;
+    const QString file = batch.file;
+    m_ingest.push(std::move(batch));
+
+    batch = IngestBatch();
+    batch.table = table;
+    batch.file = file;
+}
+
+void IngestBatcher::flush()
+{
+    for (IngestBatch *batch : {&m_movement, &m_fault}) {
+        if (batch->rows == 0)
+            continue;
+
+        const IngestBatch::Table table = batch->table;
+        const QString file = batch->file;
+        m_ingest.push(std::move(*batch));
+
+        *batch = IngestBatch();
+        batch->table = table;
+        batch->file = file;
+    }
+}
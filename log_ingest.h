@@ -0,0 +1,201 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QPair>
+#include <QQueue>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVariant>
+#include <QVariantList>
+#include <QWaitCondition>
+
+struct LogPacket;
+
+/*
+ * Bulk load of day logs into the SQL tables read by the DB backends
+ * (loco_movement_logs, loco_fault_logs).
+ *
+ * Day files are decoded concurrently, AAAA12 through
+ * LVKPosInfoParser and AAAA19 / BBBB19 through LVKFaultParser (frames
+ * failing its CRC check are dropped and counted as crcRejected). Every day
+ * fills its own IngestBatcher, which hands full batches of batchRows
+ * rows to a bounded queue. One writer thread drains the queue: each
+ * batch is one transaction of multi-row INSERT ... VALUES (...), (...)
+ * statements, prepared once per size and re-bound. A failed batch is
+ * rolled back and retried with exponential backoff (a dropped connection
+ * is replaced by a new lease, or reopened when cloned); while that goes
+ * on the queue fills up and the decoders block in push(), so a slow or
+ * flapping server throttles the producers instead of growing memory.
+ *
+ * The writer's connection is leased from DbPool, or, when
+ * Options::connection names one, cloned from that connection; a QSQLITE
+ * file works as a local stand-in for SQL Server. Tables are created when
+ * missing, in the dialect of the driver.
+ *
+ * Fault batches also add their counts to the fault summary rollup
+ * (fault_rollup.h) inside the same transaction.
+ *
+ * Re-ingesting a day does not duplicate rows. Decoding a day file gives
+ * the same rows in the same order every time (and only appends to them
+ * while the file grows), so log_ingest_days records, per file and table,
+ * how many of its rows are committed; each batch moves that count on in
+ * its own transaction. A later ingest of the file skips that many rows
+ * and writes only the rest. Once a batch of a file fails, the file's
+ * later batches are dropped as well, so the count never skips a gap.
+ * Only one ingest runs at a time.
+ *
+ * Producers run on their own thread pool, so an ingest blocked on a slow
+ * server does not hold up the report scans on LogParallel::pool().
+ */
+
+struct IngestBatch
+{
+    enum Table { Movement, Fault };
+
+    Table table = Movement;
+    QVariantList values;    // row-major, columns(table).size() per row
+    int rows = 0;
+
+    QString file;           // absolute path of the day file
+    qint64 firstRow = 0;    // index of the first row among the file's rows
+};
+
+class LogIngest
+{
+public:
+    struct Options
+    {
+        QString connection;    // empty: DbPool
+        int batchRows = 500;
+        int maxPending = 8;    // batches queued before producers block
+        int maxRetries = 4;
+    };
+
+    static constexpr int RETRY_BASE_MS = 200;
+
+    // Per INSERT statement (SQL Server: 1000 rows, 2100 parameters)
+    static constexpr int MAX_INSERT_ROWS = 1000;
+    static constexpr int MAX_INSERT_PARAMS = 2000;
+
+    explicit LogIngest(const Options &options = Options());
+    ~LogIngest();
+
+    LogIngest(const LogIngest &) = delete;
+    LogIngest &operator=(const LogIngest &) = delete;
+
+    // POST /api/ingest/logs: the days from..to (yyyy-MM-dd) of logDir
+    static QJsonObject ingestByDateRange(const QString &logDir,
+                                         const QString &fromDate,
+                                         const QString &toDate);
+
+    const Options &options() const { return m_options; }
+
+    // Decode 'paths' and queue their rows; returns once all are queued
+    void ingestDays(const QStringList &paths);
+
+    // Queue a full batch; blocks while maxPending batches wait
+    void push(IngestBatch batch);
+
+    // Wait for the writer to drain the queue; counters and timing
+    QJsonObject finish();
+
+    // Writer gave up (no connection / tables); producers may stop early
+    bool failed() const;
+
+    // Rows of 'file' already committed per table (log_ingest_days);
+    // waits until the writer has read them. False when the writer failed.
+    bool committedRows(const QString &file, qint64 &movement, qint64 &fault);
+
+    static const QStringList &columns(IngestBatch::Table table);
+    static QString tableName(IngestBatch::Table table);
+
+    // Create the ingest tables when missing
+    static bool createTables(QSqlDatabase &db, QString &error);
+
+private:
+    void writerLoop();
+
+    // log_ingest_days: committed rows per file
+    static bool readProgress(QSqlDatabase &db,
+                             QHash<QString, QPair<qint64, qint64>> &progress,
+                             QString &error);
+    static bool writeProgress(QSqlDatabase &db, const IngestBatch &batch,
+                              QSqlError &error);
+
+    // One transaction; 'statements' caches the prepared INSERTs by size
+    static bool writeBatch(QSqlDatabase &db, QHash<quint64, QSqlQuery> &statements,
+                           const IngestBatch &batch, QSqlError &error);
+
+    Options m_options;
+    QThread *m_writer = nullptr;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_queued;     // writer: batch available / finishing
+    QWaitCondition m_drained;    // producers: room in the queue
+    QWaitCondition m_started;    // producers: progress read (or failed)
+    QQueue<IngestBatch> m_queue;
+    QHash<QString, QPair<qint64, qint64>> m_progress; // file -> movement, fault
+    bool m_ready = false;
+    bool m_finishing = false;
+    bool m_failed = false;
+    bool m_finished = false;
+
+    // Counters (under m_mutex)
+    qint64 m_rowsQueued = 0;
+    qint64 m_rowsWritten = 0;
+    qint64 m_rowsFailed = 0;
+    qint64 m_rowsSkipped = 0;
+    qint64 m_crcRejected = 0;    // 0x19 frames failing LVKFaultParser::crcOk
+    qint64 m_batches = 0;
+    qint64 m_retries = 0;
+    qint64 m_producerWaits = 0;
+    qint64 m_writeMs = 0;
+    qint64 m_elapsedMs = 0;
+    QString m_lastError;
+    QElapsedTimer m_clock;
+};
+
+// Rows of one producer (one day); full batches go to LogIngest::push().
+// The first movement / fault rows given as committed are skipped.
+class IngestBatcher
+{
+public:
+    IngestBatcher(LogIngest &ingest, const QString &file,
+                  qint64 movementCommitted = 0, qint64 faultCommitted = 0);
+    ~IngestBatcher();
+
+    // AAAA12 (position info) and AAAA19 / BBBB19 (faults)
+    void addPosInfo(const LogPacket &pkt);
+    void addFault(const LogPacket &pkt);
+
+    // Queue the partial batches
+    void flush();
+
+    // Rows skipped as already committed
+    qint64 skipped() const { return m_skipped; }
+
+    // 0x19 frames dropped for a bad CRC
+    qint64 crcRejected() const { return m_crcRejected; }
+
+private:
+    // False when the next row of 'batch' was committed before
+    bool wanted(IngestBatch &batch);
+    void add(IngestBatch &batch);
+    QVariant stationCode(int stationId);
+
+    LogIngest &m_ingest;
+    IngestBatch m_movement;
+    IngestBatch m_fault;
+    qint64 m_next[2] = {0, 0};        // next row index per table
+    qint64 m_committed[2] = {0, 0};
+    qint64 m_skipped = 0;
+    qint64 m_crcRejected = 0;
+    QHash<int, QVariant> m_stationCodes;   // id -> code (null if unknown)
+};
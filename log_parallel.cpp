@@ -0,0 +1,23 @@
+#include "log_parallel.h"
+
+#include <QThread>
+
+QThreadPool* LogParallel::pool()
+{
+    static QThreadPool* p = [] {
+        auto* tp = new QThreadPool;
+        tp->setMaxThreadCount(QThread::idealThreadCount());
+        tp->setExpiryTimeout(-1);
+        return tp;
+    }();
+    return p;
+}
+
+QStringList LogParallel::dayPaths(const QString& logDir, const QDate& from,
+                                  const QDate& to)
+{
+    QStringList paths;
+    for (QDate d = from; d.isValid() && d <= to; d = d.addDays(1))
+        paths.append(LogScanner::dayFilePath(logDir, d));
+    return paths;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QDate>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+#include <functional>
+
+#include "log_scanner.h"
+
+/*
+ * Per-day work for the date-range endpoints, run on a shared thread pool.
+ *
+ * Each day file is processed on its own into a partial result; the
+ * partials come back in the order of the input paths, so callers merge
+ * them serially and produce exactly the rows of a one-by-one walk. Work
+ * items only touch their own partial (and the thread-safe day caches),
+ * never the caller's state.
+ */
+
+class LogParallel
+{
+public:
+    // Pool used for per-day work (one thread per core by default), kept
+    // apart from QThreadPool::globalInstance()
+    static QThreadPool* pool();
+
+    // fn(path) for every path, concurrently; results in 'paths' order
+    template <typename T, typename Fn>
+    static QVector<T> mapDays(const QStringList& paths, Fn fn)
+    {
+        return mapIndexed<T>(int(paths.size()),
+                             [&](int n) -> T { return fn(paths.at(n)); });
+    }
+
+    // One LogScanner per day: setup(scanner, partial, n) registers the
+    // consumers of paths[n], which write into that day's partial only
+    template <typename Partial>
+    static QVector<Partial> scanDays(
+        const QStringList& paths,
+        const std::function<void(LogScanner&, Partial&, int)>& setup)
+    {
+        return mapIndexed<Partial>(int(paths.size()), [&](int n) {
+            Partial part;
+            LogScanner scanner;
+            setup(scanner, part, n);
+            scanner.scanFile(paths.at(n));
+            return part;
+        });
+    }
+
+    // Day files from..to in date order (LogScanner::dayFilePath)
+    static QStringList dayPaths(const QString& logDir, const QDate& from,
+                                const QDate& to);
+
+private:
+    template <typename T, typename Fn>
+    static QVector<T> mapIndexed(int count, Fn fn)
+    {
+        QVector<int> items(count);
+        for (int n = 0; n < count; ++n)
+            items[n] = n;
+
+        // Nothing to share out
+        if (count < 2) {
+            QVector<T> out;
+            for (int n : items)
+                out.append(fn(n));
+            return out;
+        }
+
+        return QtConcurrent::blockingMapped<QVector<T>>(
+            pool(), items, [&fn](int n) -> T { return fn(n); });
+    }
+};
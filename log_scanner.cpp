@@ -0,0 +1,667 @@
+#include "log_scanner.h"
+#include "hex_decoder.h"
+#include "log_index.h"
+
+#include <QAtomicInteger>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+// =====================================================
+// DAY CACHE (LRU)
+// =====================================================
+
+struct LogDayCache
+{
+    QMutex mutex;
+    QHash<QString, QSharedPointer<const LogDay>> days;
+    QList<QString> order; // least recently used first
+    QSet<QString> followed;
+    qint64 bytes = 0;
+    qint64 budget = qint64(256) << 20;
+};
+
+static LogDayCache& dayCache()
+{
+    static LogDayCache cache;
+    return cache;
+}
+
+// Caller holds the mutex
+static void evict(LogDayCache& c, const QString& keep)
+{
+    for (int i = 0; i < c.order.size() && c.bytes > c.budget; ) {
+        const QString path = c.order.at(i);
+        if (path == keep || c.followed.contains(path)) {
+            ++i;
+            continue;
+        }
+
+        c.bytes -= c.days.value(path)->memoryCost();
+        c.days.remove(path);
+        c.order.removeAt(i);
+    }
+}
+
+void LogScanner::setCacheBudget(qint64 bytes)
+{
+    LogDayCache& c = dayCache();
+    QMutexLocker lock(&c.mutex);
+    c.budget = bytes;
+    evict(c, QString());
+}
+
+void LogScanner::follow(const QString& path)
+{
+    LogDayCache& c = dayCache();
+    {
+        QMutexLocker lock(&c.mutex);
+        const QString key = QFileInfo(path).absoluteFilePath();
+        c.followed.insert(key);
+
+        // Drop a mapped copy, so the reload below reads the file instead
+        auto it = c.days.constFind(key);
+        if (it != c.days.constEnd() && it.value()->file.file) {
+            c.bytes -= it.value()->memoryCost();
+            c.days.erase(it);
+            c.order.removeOne(key);
+        }
+    }
+    loadDay(path);
+}
+
+bool LogScanner::isFollowed(const QString& path)
+{
+    LogDayCache& c = dayCache();
+    QMutexLocker lock(&c.mutex);
+    return c.followed.contains(QFileInfo(path).absoluteFilePath());
+}
+
+void LogScanner::unfollow(const QString& path)
+{
+    LogDayCache& c = dayCache();
+    QMutexLocker lock(&c.mutex);
+    c.followed.remove(QFileInfo(path).absoluteFilePath());
+    evict(c, QString());
+}
+
+// =====================================================
+// FRAME SPLITTER
+// =====================================================
+
+static int hexNibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// "AAAA" / "BBBB" (any case) + a known message type
+static bool markerAt(const char* p, quint16& sof, quint8& msgType)
+{
+    const char c = p[0] & ~0x20;
+    if (c != 'A' && c != 'B')
+        return false;
+
+    for (int i = 1; i < 4; ++i)
+        if ((p[i] & ~0x20) != c)
+            return false;
+
+    const int hi = hexNibble(p[4]);
+    const int lo = hexNibble(p[5]);
+    if (hi != 1)
+        return false;
+
+    switch (lo) {
+    case 0x1: case 0x2:
+    case 0x5: case 0x6: case 0x7: case 0x8: case 0x9:
+        break;
+    default:
+        return false;
+    }
+
+    sof = (c == 'A') ? LogScanner::SOF_AAAA : LogScanner::SOF_BBBB;
+    msgType = quint8((hi << 4) | lo);
+    return true;
+}
+
+static bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Only what HexDecoder accepts: hex digits and blanks
+static bool isHexText(const char* p, qint64 start, qint64 end)
+{
+    for (qint64 i = start; i < end; ++i)
+        if (hexNibble(p[i]) < 0 && !isBlank(p[i]))
+            return false;
+    return true;
+}
+
+// Message length (bytes 3..4, counted after the SOF) as a whole-packet
+// size in hex chars; 0 when it is not on the marker's line
+static qint64 declaredHexLength(const char* p, qint64 i, qint64 end)
+{
+    if (i + 10 > end)
+        return 0;
+
+    quint16 len = 0;
+    for (int k = 6; k < 10; ++k) {
+        const int v = hexNibble(p[i + k]);
+        if (v < 0)
+            return 0;
+        len = quint16((len << 4) | v);
+    }
+    return (qint64(len) + 2) * 2;
+}
+
+// Append the frames of the lines from 'from' on.
+//
+// Packets may wrap: a line of hex that does not start with a marker
+// continues the frame before it (HexDecoder skips the line breaks). Any
+// other line ends the open frame without joining it, since one stray
+// character would fail the decode of the whole packet. Inside a line
+// a marker only starts a new frame once the open frame has reached the
+// length its header declares, so payload bytes that look like a marker
+// stay part of the packet.
+//
+// Returns where splitting has to resume when text is appended: the last
+// line that starts with a marker, since the frame it opens (and any
+// frame after it) may still be continued. Frames from there on are not
+// stable.
+static qint64 splitFrom(QByteArrayView text, qint64 from, QVector<LogFrame>& frames)
+{
+    const char* p = text.data();
+    const qint64 n = text.size();
+    qint64 lineStart = from;
+    qint64 resume = from;
+
+    LogFrame cur;
+    bool open = false;
+    qint64 frameEnd = 0;   // end of the open frame's text so far
+    qint64 seen = 0;       // hex chars of the open frame before this line
+    qint64 declared = 0;   // hex chars the open frame declares (0: unknown)
+
+    auto closeFrame = [&]() {
+        if (open) {
+            cur.length = qint32(frameEnd - cur.offset);
+            frames.append(cur);
+        }
+        open = false;
+    };
+
+    while (lineStart < n) {
+
+        const void* nl = std::memchr(p + lineStart, '\n', size_t(n - lineStart));
+        const qint64 lineEnd = nl ? static_cast<const char*>(nl) - p : n;
+
+        qint64 start = lineStart;
+        qint64 end = lineEnd;
+        while (start < end && isBlank(p[start])) ++start;
+        while (end > start && isBlank(p[end - 1])) --end;
+
+        quint16 sof;
+        quint8 type;
+        if (start + 6 <= end && markerAt(p + start, sof, type)) {
+            closeFrame();
+            resume = lineStart;
+        } else if (open && !isHexText(p, start, end)) {
+            // Not packet text; a marker further on may still open a frame
+            closeFrame();
+        }
+
+        for (qint64 i = start; i + 6 <= end; i += 2) {
+            if (open && seen + (i - start) < declared)
+                continue;
+
+            if (!markerAt(p + i, sof, type))
+                continue;
+
+            if (open) {
+                frameEnd = i;
+                closeFrame();
+            }
+
+            cur.offset = i;
+            cur.sof = sof;
+            cur.msgType = type;
+            open = true;
+            seen = -(i - start);
+            declared = declaredHexLength(p, i, end);
+            i += 4; // past the marker
+        }
+
+        if (open && end > start) {
+            frameEnd = end;
+            seen += end - start;
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    closeFrame();
+    return resume;
+}
+
+// Frames before the resume point of splitFrom()
+static qint32 stableCount(const QVector<LogFrame>& frames, qint64 splitEnd)
+{
+    qint32 n = qint32(frames.size());
+    while (n > 0 && frames.at(n - 1).offset >= splitEnd)
+        --n;
+    return n;
+}
+
+QVector<LogFrame> LogScanner::splitFrames(QByteArrayView text)
+{
+    QVector<LogFrame> frames;
+    splitFrom(text, 0, frames);
+    return frames;
+}
+
+// =====================================================
+// FILE MAPPING
+// =====================================================
+
+bool MappedFile::open(const QString& path, bool sequential)
+{
+    QSharedPointer<QFile> f(new QFile(path));
+    if (!f->open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = f->size();
+    uchar* p = size > 0 ? f->map(0, size) : nullptr;
+
+    if (!p) {
+        // Empty file, or a file system that cannot map
+        owned = f->readAll();
+        data = owned;
+        return true;
+    }
+
+#ifdef Q_OS_UNIX
+    // Full scans walk the file front to back; indexed lookups only touch
+    // the pages they need, so read-ahead would be wasted
+    madvise(p, size_t(size), sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+
+    // The mapping outlives close(); it is released with the QFile
+    f->close();
+
+    file = f;
+    data = QByteArrayView(reinterpret_cast<const char*>(p), size);
+    return true;
+}
+
+bool MappedFile::read(const QString& path, const MappedFile& prev, qint64 from)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly) || f.size() < from || !f.seek(from))
+        return false;
+
+    const QByteArray rest = f.readAll();
+
+    file.reset();
+    owned.clear();
+    owned.reserve(from + rest.size());
+    owned.append(prev.data.first(from));
+    owned.append(rest);
+    data = owned;
+    return true;
+}
+
+QSharedPointer<LogDay> LogScanner::readDay(const QString& path, bool binary, bool followed)
+{
+    QSharedPointer<LogDay> day(new LogDay);
+    if (!(followed ? day->file.read(path) : day->file.open(path)))
+        return {};
+
+    static QAtomicInteger<quint64> generations;
+    day->binary = binary;
+    day->generation = ++generations;
+
+    if (binary)
+        return LogContainer::parse(day->file.data, day->frames, day->blocks)
+                   ? day : QSharedPointer<LogDay>();
+
+    day->splitEnd = splitFrom(day->file.data, 0, day->frames);
+    day->stableFrames = stableCount(day->frames, day->splitEnd);
+    return day;
+}
+
+// The file grew: keep the stable frames, split from the last marker line
+QSharedPointer<LogDay> LogScanner::extendDay(const LogDay& prev, const QString& path,
+                                             bool followed)
+{
+    // Append-only check on the bytes just before the re-split point; a
+    // followed file reads nothing before them
+    const qint64 check = qMin<qint64>(prev.splitEnd, 64);
+
+    QSharedPointer<LogDay> day(new LogDay);
+    if (!(followed ? day->file.read(path, prev.file, prev.splitEnd - check)
+                   : day->file.open(path)))
+        return {};
+
+    const QByteArrayView text = day->file.data;
+    const QByteArrayView before = prev.file.data;
+
+    if (text.size() < before.size() ||
+        std::memcmp(text.data() + prev.splitEnd - check,
+                    before.data() + prev.splitEnd - check, size_t(check)) != 0)
+        return {};
+
+    day->frames = prev.frames;
+    day->frames.resize(prev.stableFrames);
+    day->splitEnd = splitFrom(text, prev.splitEnd, day->frames);
+    day->stableFrames = stableCount(day->frames, day->splitEnd);
+    day->decoded = prev.decoded;
+    day->generation = prev.generation;
+    return day;
+}
+
+// Decode the stable frames no run covers yet into one new run
+static void decodeStable(LogDay& day)
+{
+    qint32 first = 0;
+    if (!day.decoded.isEmpty()) {
+        const LogDecodedRun& last = day.decoded.last();
+        first = last.firstFrame + qint32(last.ends.size());
+    }
+
+    if (first >= day.stableFrames)
+        return;
+
+    LogDecodedRun run;
+    run.firstFrame = first;
+    run.ends.reserve(day.stableFrames - first);
+
+    QByteArray packet;
+    for (qint32 i = first; i < day.stableFrames; ++i) {
+        const LogFrame& f = day.frames.at(i);
+        if (HexDecoder::decode(day.file.data.sliced(f.offset, f.length), packet))
+            run.bytes.append(packet);
+        run.ends.append(qint32(run.bytes.size()));
+    }
+
+    day.decoded.append(run);
+}
+
+bool LogScanner::daySource(const QString& path, QFileInfo& source, bool& binary)
+{
+    // Prefer the container unless the hex file was written after it
+    const QFileInfo hexInfo(path);
+    const QFileInfo binInfo(LogContainer::containerPath(path));
+
+    binary = binInfo.isFile() &&
+        (!hexInfo.isFile() || binInfo.lastModified() >= hexInfo.lastModified());
+
+    source = binary ? binInfo : hexInfo;
+    return source.isFile();
+}
+
+QSharedPointer<const LogDay> LogScanner::loadDay(const QString& path)
+{
+    QFileInfo fi;
+    bool binary;
+    if (!daySource(path, fi, binary))
+        return {};
+
+    QString key = fi.absoluteFilePath();
+    LogDayCache& c = dayCache();
+
+    QSharedPointer<const LogDay> prev;
+    bool followed;
+
+    {
+        QMutexLocker lock(&c.mutex);
+        followed = !binary && c.followed.contains(key);
+
+        auto it = c.days.constFind(key);
+        if (it != c.days.constEnd()) {
+            const auto& day = it.value();
+            if (day->fileSize == fi.size() && day->modified == fi.lastModified()) {
+                c.order.removeOne(key);
+                c.order.append(key);
+                return day;
+            }
+
+            if (!binary && !day->binary && fi.size() > day->fileSize)
+                prev = day;
+
+            c.bytes -= day->memoryCost();
+            c.days.erase(it);
+            c.order.removeOne(key);
+        }
+    }
+
+    // Read + split outside the lock; a grown hex file only splits the
+    // appended text
+    QSharedPointer<LogDay> day;
+    if (prev)
+        day = extendDay(*prev, fi.filePath(), followed);
+    if (!day)
+        day = readDay(fi.filePath(), binary, followed);
+
+    if (!day && binary && QFileInfo::exists(path)) {
+        qWarning().noquote() << "Malformed log container, using hex:" << fi.filePath();
+        fi = QFileInfo(path);
+        key = fi.absoluteFilePath();
+        day = readDay(path, false, false);
+    }
+
+    if (!day)
+        return {};
+
+    if (followed && !day->binary)
+        decodeStable(*day);
+
+    day->fileSize = fi.size();
+    day->modified = fi.lastModified();
+
+    QMutexLocker lock(&c.mutex);
+    if (!c.days.contains(key)) {
+        c.days.insert(key, day);
+        c.order.append(key);
+        c.bytes += day->memoryCost();
+        evict(c, key);
+    }
+    return day;
+}
+
+QString LogScanner::dayFilePath(const QString& logDir, const QDate& day)
+{
+    return logDir + "/" + day.toString("dd-MM-yy") + ".bin";
+}
+
+// =====================================================
+// DISPATCH
+// =====================================================
+
+LogScanner& LogScanner::on(quint8 msgType, Consumer consumer)
+{
+    return on(SOF_AAAA, msgType, std::move(consumer));
+}
+
+LogScanner& LogScanner::on(quint16 sof, quint8 msgType, Consumer consumer)
+{
+    m_consumers[frameKey(sof, msgType)].append(std::move(consumer));
+    m_typeMask |= LogContainer::typeBit(msgType);
+    return *this;
+}
+
+void LogScanner::deliver(const LogFrame& f, const QVector<Consumer>& consumers,
+                         const quint8* data, int length)
+{
+    LogPacket pkt;
+    pkt.data = data;
+    pkt.length = length;
+    pkt.sof = f.sof;
+    pkt.msgType = f.msgType;
+
+    for (const Consumer& c : consumers)
+        c(pkt);
+}
+
+void LogScanner::dispatch(QByteArrayView text, const QVector<LogFrame>& frames)
+{
+    for (const LogFrame& f : frames) {
+
+        auto it = m_consumers.constFind(frameKey(f.sof, f.msgType));
+        if (it == m_consumers.constEnd())
+            continue;
+
+        if (!HexDecoder::decode(text.sliced(f.offset, f.length), m_buffer))
+            continue;
+
+        deliver(f, it.value(),
+                reinterpret_cast<const quint8*>(m_buffer.constData()),
+                int(m_buffer.size()));
+    }
+}
+
+// Container frames already hold packet bytes; no decoding, no copy
+void LogScanner::dispatchBinary(QByteArrayView data, const QVector<LogFrame>& frames,
+                                const QVector<LogBlock>& blocks)
+{
+    const quint8* base = reinterpret_cast<const quint8*>(data.data());
+
+    for (const LogBlock& b : blocks) {
+
+        if (!(b.typeMask & m_typeMask))
+            continue;
+
+        const qint32 end = b.firstFrame + qint32(b.records);
+        for (qint32 i = b.firstFrame; i < end; ++i) {
+            const LogFrame& f = frames.at(i);
+
+            auto it = m_consumers.constFind(frameKey(f.sof, f.msgType));
+            if (it != m_consumers.constEnd())
+                deliver(f, it.value(), base + f.offset, f.length);
+        }
+    }
+}
+
+// Followed day: decoded runs first, then the frames still being written
+void LogScanner::dispatchDecoded(const LogDay& day, qint32 from, qint32 to)
+{
+    int r = 0;
+
+    for (qint32 i = from; i < to; ++i) {
+        const LogFrame& f = day.frames.at(i);
+
+        auto it = m_consumers.constFind(frameKey(f.sof, f.msgType));
+        if (it == m_consumers.constEnd())
+            continue;
+
+        while (r < day.decoded.size() &&
+               i >= day.decoded[r].firstFrame + day.decoded[r].ends.size())
+            ++r;
+
+        if (r < day.decoded.size()) {
+            const LogDecodedRun& run = day.decoded[r];
+            const qint32 k = i - run.firstFrame;
+            const qint32 begin = k ? run.ends[k - 1] : 0;
+            if (run.ends[k] > begin)
+                deliver(f, it.value(),
+                        reinterpret_cast<const quint8*>(run.bytes.constData()) + begin,
+                        run.ends[k] - begin);
+            continue;
+        }
+
+        if (!HexDecoder::decode(day.file.data.sliced(f.offset, f.length), m_buffer))
+            continue;
+
+        deliver(f, it.value(),
+                reinterpret_cast<const quint8*>(m_buffer.constData()),
+                int(m_buffer.size()));
+    }
+}
+
+LogScanner& LogScanner::where(const LogQuery& query)
+{
+    m_query = query;
+    return *this;
+}
+
+// Only the frames the day index selects; the rest of the file is never
+// touched. False when there is no usable index.
+bool LogScanner::scanIndexed(const QString& path)
+{
+    QSharedPointer<const LogIndex> index = LogIndex::open(path);
+    if (!index)
+        return false;
+
+    const QByteArrayView source = index->source();
+    const quint8* base = reinterpret_cast<const quint8*>(source.data());
+
+    for (quint32 n : index->select(m_consumers.keys(), m_query)) {
+        const LogFrame f = index->frame(n);
+        if (f.offset < 0 || f.length <= 0 || f.offset + f.length > source.size())
+            continue;
+
+        auto it = m_consumers.constFind(frameKey(f.sof, f.msgType));
+        if (it == m_consumers.constEnd())
+            continue;
+
+        if (index->binary()) {
+            deliver(f, it.value(), base + f.offset, f.length);
+            continue;
+        }
+
+        if (!HexDecoder::decode(source.sliced(f.offset, f.length), m_buffer))
+            continue;
+
+        deliver(f, it.value(),
+                reinterpret_cast<const quint8*>(m_buffer.constData()),
+                int(m_buffer.size()));
+    }
+    return true;
+}
+
+bool LogScanner::scanFile(const QString& path)
+{
+    if (!m_query.isEmpty() && scanIndexed(path))
+        return true;
+
+    QSharedPointer<const LogDay> day = loadDay(path);
+    if (!day)
+        return false;
+
+    if (day->binary)
+        dispatchBinary(day->file.data, day->frames, day->blocks);
+    else if (!day->decoded.isEmpty())
+        dispatchDecoded(*day, 0, qint32(day->frames.size()));
+    else
+        dispatch(day->file.data, day->frames);
+    return true;
+}
+
+void LogScanner::scanFrames(const LogDay& day, qint32 from, qint32 to)
+{
+    if (!day.binary)
+        dispatchDecoded(day, qMax(0, from), qMin(to, qint32(day.frames.size())));
+}
+
+void LogScanner::scanBuffer(QByteArrayView text)
+{
+    if (LogContainer::isContainer(text)) {
+        QVector<LogFrame> frames;
+        QVector<LogBlock> blocks;
+        if (LogContainer::parse(text, frames, blocks))
+            dispatchBinary(text, frames, blocks);
+        return;
+    }
+
+    dispatch(text, splitFrames(text));
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QDate>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "log_container.h"
+
+/*
+ * Single-pass reader for the hex-text day logs (dd-MM-yy.bin) and for
+ * uploaded log buffers.
+ *
+ * A day file is read and split into frames once. Each frame is an
+ * AAAA/BBBB marker with a known message type (11, 12, 15..19) up to the
+ * next marker; lines of hex that do not start with a marker continue
+ * the frame before them, as packets may wrap, and any other line ends
+ * it. Markers are only recognised on byte boundaries, and not inside the
+ * length a packet's header declares. The frame table is kept in a small
+ * LRU cache keyed by path and invalidated by size + mtime, so several
+ * reports over the same day share one read.
+ *
+ * Consumers register per (SOF, message type); scanFile()/scanBuffer()
+ * then decode only the frames somebody asked for and hand out the
+ * packet bytes (SOF included).
+ *
+ * When a binary container (dd-MM-yy.rgsb, see log_container.h) exists
+ * next to the hex file and is not older than it, it is read instead:
+ * frames then point straight at packet bytes and blocks without a
+ * registered message type are skipped.
+ *
+ * A hex file that only grew since it was cached is extended in place of
+ * a reload: the frames before its last marker line are kept and only
+ * the text from there on is split again. Followed files (today's, see
+ * log_tail.h) also keep the decoded packet bytes, so repeated reads
+ * decode nothing but new frames. They are read into the heap rather than
+ * mapped, as the writer may truncate or rotate them; each growth reads
+ * only the appended text.
+ */
+
+struct LogFrame
+{
+    qint64  offset = 0;   // first hex char (packet byte for containers)
+    qint32  length = 0;   // hex text incl. line breaks (bytes for containers)
+    quint16 sof = 0;      // 0xAAAA / 0xBBBB
+    quint8  msgType = 0;
+};
+
+// Read-only file contents, memory-mapped where the file system allows it
+struct MappedFile
+{
+    QByteArrayView data;
+    QSharedPointer<QFile> file;   // owns the mapping behind 'data'
+    QByteArray owned;             // used when the file cannot be mapped
+
+    // 'sequential' advises a front-to-back walk, otherwise random access
+    bool open(const QString& path, bool sequential = true);
+
+    // Heap copy instead of a mapping, for a file that may be truncated or
+    // rotated while it is read (a mapping would then fault). Bytes before
+    // 'from' are taken from 'prev', the rest is read from the file.
+    bool read(const QString& path, const MappedFile& prev = {}, qint64 from = 0);
+};
+
+// Packet bytes of frames [firstFrame, firstFrame + ends.size()) of a
+// followed day, decoded in one go as the file grew
+struct LogDecodedRun
+{
+    qint32 firstFrame = 0;
+    QByteArray bytes;
+    QVector<qint32> ends;         // end of each packet in 'bytes'
+};
+
+struct LogDay
+{
+    MappedFile file;              // hex text or container
+    QVector<LogFrame> frames;
+    QVector<LogBlock> blocks; // containers only
+    bool binary = false;
+
+    // Hex only: splitting resumes at 'splitEnd' (the last line starting
+    // with a marker) when the file grows; frames from 'stableFrames' on
+    // start there and may still be continued, so they are split again.
+    qint64 splitEnd = 0;
+    qint32 stableFrames = 0;
+
+    QVector<LogDecodedRun> decoded; // followed days: stable frames only
+
+    // New for every full read, kept when the day is extended: frames
+    // [0, stableFrames) of days with the same generation are the same
+    quint64 generation = 0;
+
+    qint64 fileSize = 0;
+    QDateTime modified;
+
+    qint64 memoryCost() const
+    {
+        qint64 cost = file.data.size() + frames.size() * qint64(sizeof(LogFrame)) +
+                      blocks.size() * qint64(sizeof(LogBlock));
+        for (const LogDecodedRun& r : decoded)
+            cost += r.bytes.size() + r.ends.size() * qint64(sizeof(qint32));
+        return cost;
+    }
+};
+
+// Optional pre-filter for scanFile(). Fields left at ANY do not filter.
+// Answered from the day's sidecar index (log_index.h); frames whose key
+// could not be read there always pass, so consumers still check their
+// own conditions.
+struct LogQuery
+{
+    static constexpr quint32 ANY = 0xFFFFFFFF;
+
+    quint32 station = ANY;    // stationary kavach id (bytes 7..8)
+    quint32 loco = ANY;       // source / destination loco id
+    quint32 fromTime = 0;     // LogContainer::packetTime() scale
+    quint32 toTime = ANY;
+
+    bool isEmpty() const
+    {
+        return station == ANY && loco == ANY && fromTime == 0 && toTime == ANY;
+    }
+};
+
+struct LogPacket
+{
+    const quint8* data = nullptr;
+    int length = 0;
+    quint16 sof = 0;
+    quint8 msgType = 0;
+};
+
+class LogScanner
+{
+public:
+    using Consumer = std::function<void(const LogPacket&)>;
+
+    static constexpr quint16 SOF_AAAA = 0xAAAA;
+    static constexpr quint16 SOF_BBBB = 0xBBBB;
+
+    // Register a consumer for AAAA<msgType> (or another SOF) frames.
+    LogScanner& on(quint8 msgType, Consumer consumer);
+    LogScanner& on(quint16 sof, quint8 msgType, Consumer consumer);
+
+    // Restrict scanFile() to frames matching 'query' via the day index.
+    LogScanner& where(const LogQuery& query);
+
+    // Dispatch all registered frames of a day file (false if unreadable).
+    // 'path' is the hex file; its container is used when present.
+    bool scanFile(const QString& path);
+
+    // Same for an in-memory log (uploads, hex text or container);
+    // nothing is cached.
+    void scanBuffer(QByteArrayView text);
+
+    // Frames [from, to) of a hex day from loadDay(), so a caller that
+    // kept its results for the stable frames only adds the rest
+    void scanFrames(const LogDay& day, qint32 from, qint32 to);
+
+    // ---- shared helpers ----
+    static QSharedPointer<const LogDay> loadDay(const QString& path);
+
+    // File actually read for a hex day path (container or hex itself)
+    static bool daySource(const QString& path, QFileInfo& source, bool& binary);
+
+    static QVector<LogFrame> splitFrames(QByteArrayView text);
+
+    static QString dayFilePath(const QString& logDir, const QDate& day);
+
+    // Upper bound for cached day files (bytes)
+    static void setCacheBudget(qint64 bytes);
+
+    // Keep a hex day file decoded as it grows and never evict it.
+    static void follow(const QString& path);
+    static void unfollow(const QString& path);
+    static bool isFollowed(const QString& path);
+
+    // Consumer / index key of a frame
+    static quint32 frameKey(quint16 sof, quint8 msgType)
+    {
+        return (quint32(sof) << 8) | msgType;
+    }
+
+private:
+    static QSharedPointer<LogDay> readDay(const QString& path, bool binary, bool followed);
+    static QSharedPointer<LogDay> extendDay(const LogDay& prev, const QString& path,
+                                            bool followed);
+
+    void dispatch(QByteArrayView text, const QVector<LogFrame>& frames);
+    void dispatchDecoded(const LogDay& day, qint32 from, qint32 to);
+    void dispatchBinary(QByteArrayView data, const QVector<LogFrame>& frames,
+                        const QVector<LogBlock>& blocks);
+    bool scanIndexed(const QString& path);
+
+    static void deliver(const LogFrame& f, const QVector<Consumer>& consumers,
+                        const quint8* data, int length);
+
+    QHash<quint32, QVector<Consumer>> m_consumers;
+    quint32 m_typeMask = 0;   // LogContainer::typeBit of registered types
+    LogQuery m_query;
+    QByteArray m_buffer; // decode buffer reused for every frame
+};
@@ -0,0 +1,94 @@
+#include "log_tail.h"
+#include "log_parallel.h"
+#include "log_scanner.h"
+
+#include <QDate>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QPointer>
+#include <utility>
+
+LogTail::LogTail(QObject *parent)
+    : QObject(parent)
+{
+    m_refresh.setSingleShot(true);
+    m_refresh.setInterval(1000);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &LogTail::followToday);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged,
+            this, &LogTail::onFileChanged);
+    connect(&m_refresh, &QTimer::timeout,
+            this, &LogTail::refreshPending);
+}
+
+void LogTail::watchDirectory(const QString &dir)
+{
+    const QString clean = QDir::cleanPath(dir);
+    if (!QFileInfo(clean).isDir()) {
+        qWarning().noquote() << "Log directory not found:" << clean;
+        return;
+    }
+
+    m_watcher.addPath(clean);
+    followToday(clean);
+}
+
+// Switch to the current day file once it exists
+void LogTail::followToday(const QString &dir)
+{
+    const QString path = LogScanner::dayFilePath(dir, QDate::currentDate());
+    const QString current = m_today.value(dir);
+
+    if (path == current || !QFileInfo::exists(path))
+        return;
+
+    if (!current.isEmpty()) {
+        m_watcher.removePath(current);
+        LogScanner::unfollow(current);
+    }
+
+    m_today.insert(dir, path);
+    m_watcher.addPath(path);
+    LogScanner::follow(path);
+}
+
+void LogTail::onFileChanged(const QString &path)
+{
+    // Some writers replace the file; the watch is dropped then
+    if (!m_watcher.files().contains(path) && QFileInfo::exists(path))
+        m_watcher.addPath(path);
+
+    m_pending.insert(path);
+    if (!m_refresh.isActive())
+        m_refresh.start();
+}
+
+void LogTail::refreshPending()
+{
+    // Changes during a load are picked up once it is done
+    if (m_loading || m_pending.isEmpty())
+        return;
+
+    m_loading = true;
+    const QSet<QString> paths = std::exchange(m_pending, {});
+    QPointer<LogTail> self(this);
+
+    LogParallel::pool()->start([self, paths]() {
+        for (const QString &path : paths)
+            LogScanner::loadDay(path);
+
+        QMetaObject::invokeMethod(self, [self]() {
+            if (self)
+                self->refreshDone();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LogTail::refreshDone()
+{
+    m_loading = false;
+    if (!m_pending.isEmpty() && !m_refresh.isActive())
+        m_refresh.start();
+}
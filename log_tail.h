@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+/*
+ * Follows today's dd-MM-yy.bin in each watched log directory.
+ *
+ * The file is registered with LogScanner::follow(), so its frame table
+ * and decoded packets stay cached. On every change the appended text is
+ * split and decoded ahead of the next report (see LogScanner::loadDay),
+ * so a report over "today" only pays for data written since then.
+ * Changes are coalesced for a second and loaded on LogParallel::pool(),
+ * one batch at a time, off the thread LogTail lives on; a new day file
+ * created in the directory takes over from the previous one.
+ */
+
+class LogTail : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogTail(QObject *parent = nullptr);
+
+    void watchDirectory(const QString &dir);
+
+private:
+    void followToday(const QString &dir);
+    void onFileChanged(const QString &path);
+    void refreshPending();
+    void refreshDone();
+
+    QFileSystemWatcher m_watcher;
+    QHash<QString, QString> m_today;   // dir -> followed day file
+    QSet<QString> m_pending;
+    QTimer m_refresh;
+    bool m_loading = false;            // a batch is being loaded
+};
@@ -1,28 +1,7 @@
 #include "lvk_fault_parser.h"
+#include "crc32.h"
 #include <stdexcept>
 
-// ================= CRC32 (0x04C11DB7) =================
-// CRC excludes SOF (first 2 bytes)
-
-static quint32 computeCRC32(const quint8* data, int length)
-{
-    const quint32 polynomial = 0x04C11DB7;
-    quint32 crc = 0xFFFFFFFF;
-
-    for (int i = 0; i < length; ++i) {
-        crc ^= (quint32)data[i] << 24;
-
-        for (int bit = 0; bit < 8; ++bit) {
-            if (crc & 0x80000000)
-                crc = (crc << 1) ^ polynomial;
-            else
-                crc <<= 1;
-        }
-    }
-
-    return crc;
-}
-
 // ================= BASIC READERS =================
 
 quint8 LVKFaultParser::readU8(const quint8* d, int& i, int len) {
@@ -75,9 +54,28 @@ QDateTime LVKFaultParser::readDateTime(
     return dt;
 }
 
+// ================= CRC =================
+
+bool LVKFaultParser::crcOk(const quint8* frame, int length)
+{
+    // SOF (2) + type (1) + length (2) + CRC (4) at the very least
+    if (!frame || length < 9)
+        return false;
+
+    const quint8* crc = frame + length - 4;
+    const quint32 received =
+        (quint32(crc[0]) << 24) |
+        (quint32(crc[1]) << 16) |
+        (quint32(crc[2]) << 8)  |
+        quint32(crc[3]);
+
+    return received == Crc32::msbFirst(frame + 2, length - 6);
+}
+
 // ================= MAIN PARSER =================
 
-LVKFaultPacket LVKFaultParser::parse(const quint8* raw, int length)
+LVKFaultPacket LVKFaultParser::parse(const quint8* raw, int length,
+                                     bool validateCrc)
 {
     if (length < 20)
         throw std::runtime_error("Packet too small");
@@ -170,17 +168,7 @@ LVKFaultPacket LVKFaultParser::parse(const quint8* raw, int length)
     if (i + 4 > length)
         throw std::runtime_error("CRC missing");
 
-    quint32 receivedCRC =
-        (raw[i] << 24) |
-        (raw[i + 1] << 16) |
-        (raw[i + 2] << 8) |
-        raw[i + 3];
-
-    // Compute CRC excluding SOF
-    quint32 calculatedCRC =
-        computeCRC32(raw + 2, pkt.messageLength - 4);
-
-    if (receivedCRC != calculatedCRC)
+    if (validateCrc && !crcOk(raw, length))
         throw std::runtime_error("CRC mismatch");
 
     return pkt;
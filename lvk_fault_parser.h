@@ -10,7 +10,17 @@
 
 class LVKFaultParser {
 public:
-    static LVKFaultPacket parse(const quint8* raw, int length);
+    // 'validateCrc' rejects frames failing crcOk(); pass false only to
+    // look at frames whose CRC is known to be wrong
+    static LVKFaultPacket parse(const quint8* raw, int length,
+                                bool validateCrc = true);
+
+    // The one CRC check for AAAA19 / BBBB19 frames ('frame' from the SOF,
+    // 'length' including the CRC): CRC-32 0x04C11DB7, MSB-first, init
+    // 0xFFFFFFFF, no final XOR, over message type .. last fault (the
+    // bytes after the SOF, before the CRC), against the trailing 4 bytes
+    // big endian.
+    static bool crcOk(const quint8* frame, int length);
 
 private:
     // ---- byte readers ----
@@ -1,22 +1,21 @@
 #pragma once
 
 #include "lvk_pos_info_packet.h"
-#include <QByteArray>
-#include <QString>
+#include "lvk_pos_info_view.h"
+#include <QtGlobal>
 
 class LVKPosInfoParser
 {
 public:
     static LVKPosInfoPacket parse(const quint8* data, int length);
+    static LVKPosInfoPacket parse(const LVKPosInfoView& view);
 
-private:
-    static quint8  readU8 (const quint8* d, int& i, int len);
-    static quint16 readU16(const quint8* d, int& i, int len);
-    static quint32 readU32(const quint8* d, int& i, int len);
-
-    static QString bytesToBitString(const QByteArray& data);
-    static quint32 readBits(const QString& bits, int& pos, int length);
+    // Decode only the radio packet of a view (after filtering on the
+    // header). Throw when the packet type does not match.
+    static void decodeRegular(const LVKPosInfoView& view, OnboardRegularPacketModel& m);
+    static void decodeAccessRequest(const LVKPosInfoView& view, OnboardAccessRequestPacketModel& m);
 
-    static void parseRegularPacket(const QByteArray& d, int& i, OnboardRegularPacketModel& m);
-    static void parseAccessRequest(const QByteArray& d, int& i, OnboardAccessRequestPacketModel& m);
+private:
+    static void parseRegularPacket(const quint8* d, int len, int& i, OnboardRegularPacketModel& m);
+    static void parseAccessRequest(const quint8* d, int len, int& i, OnboardAccessRequestPacketModel& m);
 };
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QDateTime>
+#include <QtGlobal>
+
+/*
+ * Non-owning view over one decoded AAAA12 (LVK position info) message.
+ *
+ * Header fields are read straight from the bytes on demand. The packet
+ * time is available as integer wall-clock seconds (no QDateTime, no
+ * allocation), so date-range filters can reject packets before any
+ * field decoding happens. The bytes must outlive the view.
+ *
+ * Layout:
+ *   [2] msg type   [3..4] length   [5..6] sequence
+ *   [7..8] stationary kavach id    [9..10] NMS id   [11] version
+ *   [12..14] DD MM YY   [15..17] hh mm ss   [18] active radio
+ *   [19..20] SOF tx     [21] packet type (high nibble) ...
+ *   [len-7] MA section count   [len-6..len-5] route id
+ */
+
+class LVKPosInfoView
+{
+public:
+    static constexpr int HEADER_SIZE = 22;
+
+    LVKPosInfoView(const quint8* data, int length)
+        : m_data(data), m_length(length) {}
+
+    // Long enough for the header and the trailing route fields
+    bool isValid() const { return m_data && m_length >= HEADER_SIZE; }
+
+    const quint8* data() const { return m_data; }
+    int length() const { return m_length; }
+
+    // ---- header ----
+    quint8  messageType() const        { return m_data[2]; }
+    quint16 messageLength() const      { return u16(3); }
+    quint16 messageSequence() const    { return u16(5); }
+    quint16 stationaryKavachId() const { return u16(7); }
+    quint16 nmsSystemId() const        { return u16(9); }
+    quint8  systemVersion() const      { return m_data[11]; }
+    quint8  activeRadio() const        { return m_data[18]; }
+    int     packetType() const         { return (m_data[21] >> 4) & 0x0F; }
+
+    // Byte index of the radio packet (packet type nibble)
+    int radioPacketOffset() const { return 21; }
+
+    quint8  noOfMASections() const { return m_data[m_length - 7]; }
+    quint16 routeId() const        { return u16(m_length - 6); }
+
+    // ---- time ----
+    int day() const    { return m_data[12]; }
+    int month() const  { return m_data[13]; }
+    int year() const   { return 2000 + m_data[14]; }
+    int hour() const   { return m_data[15]; }
+    int minute() const { return m_data[16]; }
+    int second() const { return m_data[17]; }
+
+    // Packet time as seconds since 1970-01-01 00:00 on the same wall
+    // clock as the log (no time zone applied), or -1 when the date or
+    // time fields are invalid.
+    qint64 wallSeconds() const
+    {
+        if (month() < 1 || month() > 12 ||
+            day() < 1 || day() > daysInMonth(year(), month()) ||
+            hour() > 23 || minute() > 59 || second() > 59)
+            return -1;
+
+        return civilSeconds(year(), month(), day(),
+                            hour(), minute(), second());
+    }
+
+    // Materialize the timestamp (only for rows that are emitted).
+    QDateTime dateTime() const
+    {
+        return QDateTime(QDate(year(), month(), day()),
+                         QTime(hour(), minute(), second()));
+    }
+
+    // Same scale as wallSeconds(), for the filter bounds. Converted to
+    // local time first, as LogContainer::wallTime() does, so a UTC or
+    // offset bound selects the same packets on both paths.
+    static qint64 wallSeconds(const QDateTime& dt)
+    {
+        const QDateTime local = dt.toLocalTime();
+        const QDate d = local.date();
+        const QTime t = local.time();
+        return civilSeconds(d.year(), d.month(), d.day(),
+                            t.hour(), t.minute(), t.second());
+    }
+
+private:
+    quint16 u16(int i) const
+    {
+        return quint16((m_data[i] << 8) | m_data[i + 1]);
+    }
+
+    static int daysInMonth(int y, int m)
+    {
+        static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+        return (m == 2 && leap) ? 29 : days[m - 1];
+    }
+
+    // Seconds since 1970-01-01 00:00 for a proleptic Gregorian date/time
+    static qint64 civilSeconds(int y, int m, int d, int hh, int mm, int ss)
+    {
+        y -= m <= 2;
+        const qint64 era = (y >= 0 ? y : y - 399) / 400;
+        const qint64 yoe = y - era * 400;
+        const qint64 doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const qint64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        const qint64 days = era * 146097 + doe - 719468;
+
+        return days * 86400 + hh * 3600 + mm * 60 + ss;
+    }
+
+    const quint8* m_data = nullptr;
+    int m_length = 0;
+};
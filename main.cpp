@@ -8,12 +8,18 @@
 #include <QJsonDocument>
 #include <QHttpHeaders>
 #include <QJsonArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QFileInfo>
+#include <QDir>
+#include <QThreadPool>
 
 
 // Backend modules
 #include "backend_database.h"
 #include "backend_loco_fault.h"
 #include "backend_db.h"
+#include "backend_fault_summary.h"
 #include "backend_loco_movement.h"
 #include "backend_interlocking.h"
 #include "graph_backend.h"
@@ -21,6 +27,12 @@
 #include "track_profile_report_backend.h"
 #include "backend_stationary_kavach.h"
 #include "backend_stationary_health.h"
+#include "log_container.h"
+#include "log_tail.h"
+#include "route_pool.h"
+#include "db_pool.h"
+#include "fault_listing.h"
+#include "log_ingest.h"
 
 #undef QT_NO_DEBUG_OUTPUT
 
@@ -50,10 +62,66 @@ QHttpServerResponse corsResponse(
     return res;
 }
 
+// =====================================================
+// NDJSON streaming is opt-in: stream=1 or Accept: application/x-ndjson
+// =====================================================
+static bool wantsStream(const QHttpServerRequest &req)
+{
+    if (QUrlQuery(req.url().query()).queryItemValue("stream") == "1")
+        return true;
+
+    return req.headers().value(QHttpHeaders::WellKnownHeader::Accept)
+        .contains("application/x-ndjson");
+}
+
+// =====================================================
+// CBOR for the graph series: format=cbor or Accept: application/cbor
+// =====================================================
+static bool wantsCbor(const QHttpServerRequest &req)
+{
+    if (QUrlQuery(req.url().query()).queryItemValue("format") == "cbor")
+        return true;
+
+    return req.headers().value(QHttpHeaders::WellKnownHeader::Accept)
+        .contains("application/cbor");
+}
+
+QHttpServerResponse cborResponse(const QCborMap &body)
+{
+    QHttpServerResponse res("application/cbor", body.toCborValue().toCbor());
+    res.setHeaders(createCorsHeaders());
+    return res;
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
 
+    // =====================================================
+    // OFFLINE: --convert <logDir | dd-MM-yy.bin>...
+    // Writes dd-MM-yy.rgsb next to each hex day file
+    // =====================================================
+    const QStringList args = app.arguments();
+    if (args.size() > 1 && args.at(1) == "--convert") {
+        int failed = 0;
+        for (const QString &target : args.mid(2)) {
+            if (QFileInfo(target).isDir()) {
+                int n = LogContainer::convertDir(target);
+                if (n < 0) failed++;
+                qInfo().noquote() << "Converted" << n << "file(s) in" << target;
+            } else {
+                QString error;
+                if (LogContainer::convert(target, LogContainer::containerPath(target), &error))
+                    qInfo().noquote() << "Converted" << target;
+                else {
+                    qWarning().noquote() << error;
+                    failed++;
+                }
+            }
+        }
+        return failed ? 1 : 0;
+    }
+
     QHttpServer httpServer;
     QTcpServer tcpServer;
 
@@ -78,6 +146,15 @@ int main(int argc, char *argv[])
         });
     });
 
+    // =====================================================
+    // WORKER POOLS (queue depth / wait times)
+    // =====================================================
+    httpServer.route("/api/server/pools", []() {
+        QJsonObject stats = RoutePool::stats();
+        stats["database"] = DbPool::stats();
+        return corsResponse(stats);
+    });
+
 
 
     // =====================================================
@@ -163,9 +240,12 @@ int main(int argc, char *argv[])
 
             QByteArray fileData = req.body();  // uploaded file
 
-            return corsResponse(
-                BackendLocoMovement::fetchByDateRange(fromDate, toDate, fileData)
-                );
+            // Parsing the upload is a log scan, not a DB lookup
+            return RoutePool::run(RoutePool::Scan, [=] {
+                return corsResponse(
+                    BackendLocoMovement::fetchByDateRange(fromDate, toDate, fileData)
+                    );
+            });
         }
         );
 
@@ -213,9 +293,28 @@ int main(int argc, char *argv[])
         //         fromDate.toUtf8().constData(),
         //         toDate.toUtf8().constData());
         // fflush(stderr);
-        return corsResponse(
-            BackendLocoMovement::fetchLatest(100)
-            );
+        return RoutePool::run(RoutePool::Meta, [] {
+            return corsResponse(
+                BackendLocoMovement::fetchLatest(100)
+                );
+        });
+    });
+
+
+    // =====================================================
+    // FAULT SUMMARY (station-wise, from the daily rollup)
+    // =====================================================
+    httpServer.route("/api/fault-summary", [](const QHttpServerRequest &req) {
+        QUrlQuery query(req.url().query());
+
+        QString fromDate = query.queryItemValue("from");
+        QString toDate   = query.queryItemValue("to");
+
+        return RoutePool::run(RoutePool::Meta, [=] {
+            return corsResponse(
+                BackendFaultSummary::getSummary(fromDate, toDate)
+                );
+        });
     });
 
 
@@ -240,7 +339,7 @@ int main(int argc, char *argv[])
     // --------------------------------------------
     httpServer.route(
         "/api/loco-faults/by-date",
-        [](const QHttpServerRequest &req) {
+        [](const QHttpServerRequest &req, QHttpServerResponder &responder) {
 
             QUrlQuery query(req.url().query());
 
@@ -248,9 +347,22 @@ int main(int argc, char *argv[])
             QString toDate   = query.queryItemValue("to");
             QString logDir   = query.queryItemValue("logDir");
 
-            return corsResponse(
-                BackendLocoFault::fetchByDateRange(fromDate, toDate, logDir)
-                );
+            // Frames failing the CRC are dropped; crc=0 keeps them
+            bool validateCrc = query.queryItemValue("crc") != "0";
+
+            if (wantsStream(req)) {
+                RoutePool::stream(RoutePool::Scan, responder, [=](const RowSink &sink) {
+                    return BackendLocoFault::fetchByDateRange(
+                        fromDate, toDate, logDir, validateCrc, sink);
+                });
+                return;
+            }
+
+            RoutePool::respond(RoutePool::Scan, responder, [=] {
+                return corsResponse(
+                    BackendLocoFault::fetchByDateRange(fromDate, toDate, logDir, validateCrc)
+                    );
+            });
         }
         );
 
@@ -267,13 +379,15 @@ int main(int argc, char *argv[])
             QString to     = query.queryItemValue("to");
             QString logDir = query.queryItemValue("logDir");
 
-            return corsResponse(
-                BackendInterlocking().getStationsForDateRange(
-                    logDir,
-                    from,
-                    to
-                    )
-                );
+            return RoutePool::run(RoutePool::Meta, [=] {
+                return corsResponse(
+                    BackendInterlocking().getStationsForDateRange(
+                        logDir,
+                        from,
+                        to
+                        )
+                    );
+            });
         }
         );
 
@@ -283,7 +397,7 @@ int main(int argc, char *argv[])
     // =====================================================
     httpServer.route(
         "/api/interlocking/report",
-        [](const QHttpServerRequest &req) {
+        [](const QHttpServerRequest &req, QHttpServerResponder &responder) {
 
             QUrlQuery query(req.url().query());
 
@@ -291,19 +405,59 @@ int main(int argc, char *argv[])
             QString to          = query.queryItemValue("to");
             QString logDir      = query.queryItemValue("logDir");
             QString stationCode = query.queryItemValue("station");
+            QString mode        = query.queryItemValue("mode");
             int page            = query.queryItemValue("page").toInt();
 
             if (page <= 0) page = 1;
 
-            return corsResponse(
-                BackendInterlocking().generateReportByDateRange(
-                    logDir,
-                    from,
-                    to,
-                    stationCode,
-                    page
-                    )
-                );
+            const bool useCursor = query.hasQueryItem("cursor");
+            QString cursor       = query.queryItemValue("cursor");
+
+            // Streamed: the whole range, no pages or cursor
+            if (mode != "transitions" && wantsStream(req)) {
+                RoutePool::stream(RoutePool::Scan, responder, [=](const RowSink &sink) {
+                    return BackendInterlocking().streamReportByDateRange(
+                        logDir, from, to, stationCode, sink);
+                });
+                return;
+            }
+
+            RoutePool::respond(RoutePool::Scan, responder, [=] {
+
+                // mode=transitions: only relays that changed state
+                if (mode == "transitions")
+                    return corsResponse(
+                        BackendInterlocking().generateTransitionsByDateRange(
+                            logDir,
+                            from,
+                            to,
+                            stationCode,
+                            page
+                            )
+                        );
+
+                // cursor=<nextCursor>: resume where the last page stopped
+                if (useCursor)
+                    return corsResponse(
+                        BackendInterlocking().generateReportFromCursor(
+                            logDir,
+                            from,
+                            to,
+                            stationCode,
+                            cursor
+                            )
+                        );
+
+                return corsResponse(
+                    BackendInterlocking().generateReportByDateRange(
+                        logDir,
+                        from,
+                        to,
+                        stationCode,
+                        page
+                        )
+                    );
+            });
         }
         );
 
@@ -318,13 +472,15 @@ int main(int argc, char *argv[])
         QString from   = query.queryItemValue("from");
         QString to     = query.queryItemValue("to");
 
-        return corsResponse(
-            GraphBackend::getGraphMeta(
-                QUrl::fromPercentEncoding(logDir.toUtf8()),
-                from,
-                to
-                )
-            );
+        return RoutePool::run(RoutePool::Meta, [=] {
+            return corsResponse(
+                GraphBackend::getGraphMeta(
+                    QUrl::fromPercentEncoding(logDir.toUtf8()),
+                    from,
+                    to
+                    )
+                );
+        });
     });
 
 
@@ -348,23 +504,44 @@ int main(int argc, char *argv[])
             if (locoId.isEmpty() || fromDate.isEmpty() || toDate.isEmpty() ||
                 direction.isEmpty() || graphType.isEmpty() || logDir.isEmpty())
             {
-                return corsResponse({
+                return RoutePool::ready(corsResponse({
                     {"success", false},
                     {"error", "Missing required query parameters"}
-                });
+                }));
             }
 
-            return corsResponse(
-                GraphBackend::getGraphData(
-                    locoId,
-                    fromDate,
-                    toDate,
-                    direction,
-                    QString(), // profileId (reserved)
-                    graphType,
-                    QUrl::fromPercentEncoding(logDir.toUtf8())
-                    )
-                );
+            const bool cbor = wantsCbor(req);
+            const GraphReduction reduce = GraphReduction::fromQuery(
+                query.queryItemValue("downsample"), query.queryItemValue("maxPoints"));
+
+            return RoutePool::run(RoutePool::Scan, [=] {
+                if (cbor)
+                    return cborResponse(
+                        GraphBackend::getGraphDataCbor(
+                            locoId,
+                            fromDate,
+                            toDate,
+                            direction,
+                            QString(), // profileId (reserved)
+                            graphType,
+                            QUrl::fromPercentEncoding(logDir.toUtf8()),
+                            reduce
+                            )
+                        );
+
+                return corsResponse(
+                    GraphBackend::getGraphData(
+                        locoId,
+                        fromDate,
+                        toDate,
+                        direction,
+                        QString(), // profileId (reserved)
+                        graphType,
+                        QUrl::fromPercentEncoding(logDir.toUtf8()),
+                        reduce
+                        )
+                    );
+            });
         }
         );
     // =====================================================
@@ -381,13 +558,15 @@ int main(int argc, char *argv[])
             QString from   = query.queryItemValue("from");
             QString to     = query.queryItemValue("to");
 
-            return corsResponse(
-                TrackProfileGraphBackend::getMeta(
-                    QUrl::fromPercentEncoding(logDir.toUtf8()),
-                    from,
-                    to
-                    )
-                );
+            return RoutePool::run(RoutePool::Meta, [=] {
+                return corsResponse(
+                    TrackProfileGraphBackend::getMeta(
+                        QUrl::fromPercentEncoding(logDir.toUtf8()),
+                        from,
+                        to
+                        )
+                    );
+            });
         }
         );
 
@@ -414,23 +593,44 @@ int main(int argc, char *argv[])
                 profileId.isEmpty() || fromDate.isEmpty() || toDate.isEmpty() ||
                 logDir.isEmpty())
             {
-                return corsResponse({
+                return RoutePool::ready(corsResponse({
                     {"success", false},
                     {"error", "Missing required query parameters"}
-                });
+                }));
             }
 
-            return corsResponse(
-                TrackProfileGraphBackend::getGraphData(
-                    locoId,
-                    station,
-                    direction,
-                    profileId,
-                    fromDate,
-                    toDate,
-                    QUrl::fromPercentEncoding(logDir.toUtf8())
-                    )
-                );
+            const bool cbor = wantsCbor(req);
+            const GraphReduction reduce = GraphReduction::fromQuery(
+                query.queryItemValue("downsample"), query.queryItemValue("maxPoints"));
+
+            return RoutePool::run(RoutePool::Scan, [=] {
+                if (cbor)
+                    return cborResponse(
+                        TrackProfileGraphBackend::getGraphDataCbor(
+                            locoId,
+                            station,
+                            direction,
+                            profileId,
+                            fromDate,
+                            toDate,
+                            QUrl::fromPercentEncoding(logDir.toUtf8()),
+                            reduce
+                            )
+                        );
+
+                return corsResponse(
+                    TrackProfileGraphBackend::getGraphData(
+                        locoId,
+                        station,
+                        direction,
+                        profileId,
+                        fromDate,
+                        toDate,
+                        QUrl::fromPercentEncoding(logDir.toUtf8()),
+                        reduce
+                        )
+                    );
+            });
         }
         );
 
@@ -467,22 +667,55 @@ int main(int argc, char *argv[])
 
             if (from.isEmpty() || to.isEmpty() || logDir.isEmpty())
             {
-                return corsResponse({
+                return RoutePool::ready(corsResponse({
                     {"success", false},
                     {"error", "Missing required query parameters"}
-                });
+                }));
             }
 
-            return corsResponse(
-                TrackProfileReportBackend::getReport(
-                    from,
-                    to,
-                    QUrl::fromPercentEncoding(logDir.toUtf8()),
-                    stations
-                    )
-                );
+            return RoutePool::run(RoutePool::Scan, [=] {
+                return corsResponse(
+                    TrackProfileReportBackend::getReport(
+                        from,
+                        to,
+                        QUrl::fromPercentEncoding(logDir.toUtf8()),
+                        stations
+                        )
+                    );
+            });
         }
         );
+
+    // --------------------------------------------
+    // INGEST DAY LOGS INTO THE SQL TABLES
+    // --------------------------------------------
+    httpServer.route(
+        "/api/ingest/logs",
+        QHttpServerRequest::Method::Options,
+        []() {
+            QHttpServerResponse res(QHttpServerResponse::StatusCode::NoContent);
+            res.setHeaders(createCorsHeaders());
+            return res;
+        }
+        );
+
+    httpServer.route(
+        "/api/ingest/logs",
+        QHttpServerRequest::Method::Post,
+        [](const QHttpServerRequest& req, QHttpServerResponder &responder) {
+
+            QUrlQuery q(req.url().query());
+
+            QString from   = q.queryItemValue("from");
+            QString to     = q.queryItemValue("to");
+            QString logDir = q.queryItemValue("logDir");
+
+            RoutePool::respond(RoutePool::Scan, responder, [=] {
+                return corsResponse(LogIngest::ingestByDateRange(logDir, from, to));
+            });
+        }
+        );
+
     httpServer.route(
         "/api/stationary/regular/by-date",
         QHttpServerRequest::Method::Options,
@@ -499,17 +732,26 @@ int main(int argc, char *argv[])
     httpServer.route(
         "/api/stationary/regular/by-date",
         QHttpServerRequest::Method::Post,
-        [](const QHttpServerRequest& req) {
+        [](const QHttpServerRequest& req, QHttpServerResponder &responder) {
 
             QUrlQuery q(req.url().query());
 
-            return corsResponse(
-                BackendStationaryKavach::fetchRegular(
-                    q.queryItemValue("from"),
-                    q.queryItemValue("to"),
-                    req.body()   // <-- FILE DATA
-                    )
-                );
+            QString from    = q.queryItemValue("from");
+            QString to      = q.queryItemValue("to");
+            QByteArray body = req.body();   // <-- FILE DATA
+
+            if (wantsStream(req)) {
+                RoutePool::stream(RoutePool::Scan, responder, [=](const RowSink &sink) {
+                    return BackendStationaryKavach::fetchRegular(from, to, body, sink);
+                });
+                return;
+            }
+
+            RoutePool::respond(RoutePool::Scan, responder, [=] {
+                return corsResponse(
+                    BackendStationaryKavach::fetchRegular(from, to, body)
+                    );
+            });
         }
         );
     httpServer.route(
@@ -525,17 +767,26 @@ int main(int argc, char *argv[])
     httpServer.route(
         "/api/stationary/access/by-date",
         QHttpServerRequest::Method::Post,
-        [](const QHttpServerRequest& req) {
+        [](const QHttpServerRequest& req, QHttpServerResponder &responder) {
 
             QUrlQuery q(req.url().query());
 
-            return corsResponse(
-                BackendStationaryKavach::fetchAccess(
-                    q.queryItemValue("from"),
-                    q.queryItemValue("to"),
-                    req.body()   // <-- FILE DATA
-                    )
-                );
+            QString from    = q.queryItemValue("from");
+            QString to      = q.queryItemValue("to");
+            QByteArray body = req.body();   // <-- FILE DATA
+
+            if (wantsStream(req)) {
+                RoutePool::stream(RoutePool::Scan, responder, [=](const RowSink &sink) {
+                    return BackendStationaryKavach::fetchAccess(from, to, body, sink);
+                });
+                return;
+            }
+
+            RoutePool::respond(RoutePool::Scan, responder, [=] {
+                return corsResponse(
+                    BackendStationaryKavach::fetchAccess(from, to, body)
+                    );
+            });
         }
         );
 
@@ -553,17 +804,26 @@ int main(int argc, char *argv[])
     httpServer.route(
         "/api/stationary/emergency/by-date",
         QHttpServerRequest::Method::Post,
-        [](const QHttpServerRequest& req) {
+        [](const QHttpServerRequest& req, QHttpServerResponder &responder) {
 
             QUrlQuery q(req.url().query());
 
-            return corsResponse(
-                BackendStationaryKavach::fetchEmergency(
-                    q.queryItemValue("from"),
-                    q.queryItemValue("to"),
-                    req.body()   // <-- FILE DATA
-                    )
-                );
+            QString from    = q.queryItemValue("from");
+            QString to      = q.queryItemValue("to");
+            QByteArray body = req.body();   // <-- FILE DATA
+
+            if (wantsStream(req)) {
+                RoutePool::stream(RoutePool::Scan, responder, [=](const RowSink &sink) {
+                    return BackendStationaryKavach::fetchEmergency(from, to, body, sink);
+                });
+                return;
+            }
+
+            RoutePool::respond(RoutePool::Scan, responder, [=] {
+                return corsResponse(
+                    BackendStationaryKavach::fetchEmergency(from, to, body)
+                    );
+            });
         }
         );
 
@@ -571,6 +831,15 @@ int main(int argc, char *argv[])
 
 
 
+    // =====================================================
+    // FOLLOW TODAY'S LOGS (LOG_DIRS, path-list separated)
+    // =====================================================
+    LogTail logTail;
+    const QStringList logDirs =
+        qEnvironmentVariable("LOG_DIRS").split(QDir::listSeparator(), Qt::SkipEmptyParts);
+    for (const QString &dir : logDirs)
+        logTail.watchDirectory(dir.trimmed());
+
     // =====================================================
     // SERVER START
     // =====================================================
@@ -585,5 +854,8 @@ int main(int argc, char *argv[])
     httpServer.bind(&tcpServer);
     qInfo() << " Backend running on http://localhost:8080";
 
+    // Warn about missing fault listing indexes without delaying startup
+    QThreadPool::globalInstance()->start([] { FaultListing::checkIndexes(); });
+
     return app.exec();
 }
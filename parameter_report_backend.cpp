@@ -1,49 +1,11 @@
 #include "parameter_report_backend.h"
 
-#include <QFile>
 #include <QDate>
 #include <QJsonArray>
+#include <cstring>
 
-/* =====================================================
-   HELPERS
-   ===================================================== */
-
-QString ParameterReportBackend::hexToBin(const QString &hex)
-{
-    QString bin;
-    for (QChar c : hex)
-    {
-        bool ok;
-        int v = QString(c).toInt(&ok, 16);
-        if (ok)
-            bin += QString("%1").arg(v, 4, 2, QChar('0'));
-    }
-    return bin;
-}
-
-QStringList ParameterReportBackend::readBinFile(const QString &filePath)
-{
-    QFile file(filePath);
-    QStringList packets;
-
-    if (!file.open(QIODevice::ReadOnly))
-        return packets;
-
-    QString raw = file.readAll().toUpper();
-    raw.replace("\r", "");
-    raw.replace("\n", "");
-
-    raw.replace("AAAA11", "|AAAA11");
-    raw.replace("AAAA17", "|AAAA17");
-    raw.replace("BBBB18", "|BBBB18");
-
-    QStringList split = raw.split("|", Qt::SkipEmptyParts);
-    for (const QString &pkt : split)
-        if (pkt.startsWith("AAAA") || pkt.startsWith("BBBB"))
-            packets.append(pkt);
-
-    return packets;
-}
+#include "bit_reader.h"
+#include "log_scanner.h"
 
 /* =====================================================
    ROW FACTORY
@@ -66,12 +28,19 @@ QJsonObject ParameterReportBackend::makeRow(
 
 void ParameterReportBackend::processPacket(
     const QString &station,
-    const QString &payloadBin,
+    const quint8 *payload,
+    qint64 payloadLen,
     const QString &packetType,
     QMap<QString, QMap<QString, QJsonObject>> &stationParamMap,
     QMap<QString, int> &packetCountMap
     )
 {
+    // Payload bits, MSB first
+    const qint64 payloadBits = payloadLen * 8;
+    auto bit = [&](qint64 pos) {
+        return int(BitReader::extract(payload, payloadLen, pos, 1));
+    };
+
     // =================================================
     // COMMON COUNTERS
     // =================================================
@@ -90,7 +59,7 @@ void ParameterReportBackend::processPacket(
     // -------------------------------------------------
     if (!stationParamMap[station].contains("Packet Length (bits)")) {
         stationParamMap[station]["Packet Length (bits)"] =
-            makeRow(station, "Packet Length (bits)", payloadBin.length(), "OK");
+            makeRow(station, "Packet Length (bits)", payloadBits, "OK");
     }
 
     // -------------------------------------------------
@@ -112,8 +81,8 @@ void ParameterReportBackend::processPacket(
             makeRow(station, "TX Packet Count", txCount, "OK");
 
         // ---- AKey Set ----
-        int akey = (payloadBin.length() > 8)
-                       ? payloadBin.mid(8, 1).toInt()
+        int akey = (payloadBits > 8)
+                       ? bit(8)
                        : 0;
 
         stationParamMap[station]["AKey Set"] =
@@ -125,8 +94,8 @@ void ParameterReportBackend::processPacket(
                 );
 
         // ---- Reverse Power (scaled) ----
-        int raw = (payloadBin.length() > 24)
-                      ? payloadBin.mid(16, 8).toInt(nullptr, 2)
+        int raw = (payloadBits > 24)
+                      ? int(BitReader::extract(payload, payloadLen, 16, 8))
                       : 0;
 
         // Desktop scaling (example: raw × 5)
@@ -154,8 +123,8 @@ void ParameterReportBackend::processPacket(
             makeRow(station, "RX Packet Count", rxCount, "OK");
 
         // ---- Emergency Brake ----
-        int ebrake = (payloadBin.length() > 9)
-                         ? payloadBin.mid(9, 1).toInt()
+        int ebrake = (payloadBits > 9)
+                         ? bit(9)
                          : 0;
 
         stationParamMap[station]["Emergency Brake"] =
@@ -167,8 +136,8 @@ void ParameterReportBackend::processPacket(
                 );
 
         // ---- Radio Health (FAULT dominates) ----
-        int radio = (payloadBin.length() > 32)
-                        ? payloadBin.mid(32, 1).toInt()
+        int radio = (payloadBits > 32)
+                        ? bit(32)
                         : 0;
 
         QString prevStatus =
@@ -186,8 +155,8 @@ void ParameterReportBackend::processPacket(
                 );
 
         // ---- Tag Missing ----
-        int tag = (payloadBin.length() > 33)
-                      ? payloadBin.mid(33, 1).toInt()
+        int tag = (payloadBits > 33)
+                      ? bit(33)
                       : 0;
 
         stationParamMap[station]["Tag Missing"] =
@@ -199,8 +168,8 @@ void ParameterReportBackend::processPacket(
                 );
 
         // ---- Onboard KAVACH Health ----
-        int kavach = (payloadBin.length() > 34)
-                         ? payloadBin.mid(34, 1).toInt()
+        int kavach = (payloadBits > 34)
+                         ? bit(34)
                          : 0;
 
         stationParamMap[station]["Onboard KAVACH Health"] =
@@ -242,47 +211,44 @@ QJsonObject ParameterReportBackend::getReport(
     QMap<QString, QMap<QString, QJsonObject>> stationParamMap;
     QMap<QString, int> packetCountMap;
 
-    for (QDate d = from; d <= to; d = d.addDays(1))
+    auto onPacket = [&](const LogPacket &pkt)
     {
-        QString binPath = logDir + "/" + d.toString("dd-MM-yy") + ".bin";
-        QStringList packets = readBinFile(binPath);
-
-        for (const QString &pkt : packets)
-        {
-            int c3Index = pkt.indexOf("C3");
-            if (c3Index < 0)
-                continue;
-
-            QString stationHex = pkt.mid(14, 4);
-            QString station =
-                QString::number(stationHex.toInt(nullptr, 16));
-
-            QString payloadHex = pkt.mid(c3Index + 2);
-            QString payloadBin = hexToBin(payloadHex);
-
-            if (payloadBin.isEmpty())
-                continue;
-
-            QString packetType;
-            if (pkt.startsWith("AAAA17"))
-                packetType = "17";
-            else if (pkt.startsWith("BBBB18"))
-                packetType = "18";
-            else
-                continue;
-
-            processPacket(
-                station,
-                payloadBin,
-                packetType,
-                stationParamMap,
-                packetCountMap
-                );
+        if (pkt.length < 9)
+            return;
 
+        const quint8 *c3 = static_cast<const quint8 *>(
+            std::memchr(pkt.data, 0xC3, size_t(pkt.length)));
+        if (!c3)
+            return;
 
-            hasData = true;
-        }
-    }
+        QString station =
+            QString::number((pkt.data[7] << 8) | pkt.data[8]);
+
+        const quint8 *payload = c3 + 1;
+        const qint64 payloadLen = pkt.length - (payload - pkt.data);
+
+        if (payloadLen <= 0)
+            return;
+
+        processPacket(
+            station,
+            payload,
+            payloadLen,
+            pkt.msgType == 0x17 ? "17" : "18",
+            stationParamMap,
+            packetCountMap
+            );
+
+
+        hasData = true;
+    };
+
+    LogScanner scanner;
+    scanner.on(LogScanner::SOF_AAAA, 0x17, onPacket);
+    scanner.on(LogScanner::SOF_BBBB, 0x18, onPacket);
+
+    for (QDate d = from; d <= to; d = d.addDays(1))
+        scanner.scanFile(LogScanner::dayFilePath(logDir, d));
 
     // ---- Final Packet Count rows ----
     for (auto it = packetCountMap.begin(); it != packetCountMap.end(); ++it)
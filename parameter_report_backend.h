@@ -16,14 +16,11 @@ public:
         );
 
 private:
-    // Helpers
-    static QString hexToBin(const QString &hex);
-    static QStringList readBinFile(const QString &filePath);
-
     // Core
     static void processPacket(
         const QString &station,
-        const QString &payloadBin,
+        const quint8 *payload,
+        qint64 payloadLen,
         const QString &packetType,
         QMap<QString, QMap<QString, QJsonObject>> &stationParamMap,
         QMap<QString, int> &packetCountMap
@@ -0,0 +1,158 @@
+#include "relay_state_store.h"
+#include "day_cache.h"
+
+#include <QSet>
+
+// =====================================================
+// STATE
+// =====================================================
+
+QBitArray RelayStationLog::stateAt(quint32 time, const QHash<int, int> &indexOf) const
+{
+    int start = entries.size() - 1;
+    while (start >= 0 &&
+           (entries.at(start).snapshot < 0 || entries.at(start).time > time))
+        --start;
+
+    if (start < 0)
+        return {};
+
+    QBitArray state = snapshots.at(entries.at(start).snapshot);
+
+    for (int e = start + 1; e < entries.size(); ++e) {
+        const RelayEntry &entry = entries.at(e);
+        if (entry.snapshot >= 0 || entry.time > time)
+            continue;
+
+        for (int i = 0; i < entry.deltaCount; ++i) {
+            const RelayDelta &d = deltas.at(entry.firstDelta + i);
+            const int index = indexOf.value(d.address, -1);
+            if (index >= 0 && index < state.size())
+                state.setBit(index, d.set);
+        }
+    }
+
+    return state;
+}
+
+bool RelayStationLog::hasSnapshotIn(quint32 fromTime, quint32 toTime) const
+{
+    for (const RelayEntry &e : entries)
+        if (e.snapshot >= 0 && e.time >= fromTime && e.time <= toTime)
+            return true;
+    return false;
+}
+
+qint64 RelayDayState::memoryCost() const
+{
+    qint64 cost = 0;
+    QSet<const char *> shared;
+
+    for (const RelayStationLog &s : stations) {
+        cost += s.entries.size() * qint64(sizeof(RelayEntry)) +
+                s.deltas.size() * qint64(sizeof(RelayDelta)) +
+                s.snapshots.size() * qint64(sizeof(QBitArray));
+
+        for (const QBitArray &b : s.snapshots)
+            if (!shared.contains(b.bits())) {
+                shared.insert(b.bits());
+                cost += (b.size() + 7) / 8;
+            }
+    }
+    return cost;
+}
+
+void RelayDayState::squeeze()
+{
+    for (RelayStationLog &s : stations) {
+        s.entries.squeeze();
+        s.snapshots.squeeze();
+        s.deltas.squeeze();
+    }
+}
+
+// =====================================================
+// CACHE
+// =====================================================
+
+static DayCache<RelayDayState> &stateCache()
+{
+    static DayCache<RelayDayState> cache(qint64(64) << 20);
+    return cache;
+}
+
+void RelayStateStore::setCacheBudget(qint64 bytes)
+{
+    stateCache().setBudget(bytes);
+}
+
+// =====================================================
+// BUILD
+// =====================================================
+
+static void buildDay(LogScanner &scanner, RelayDayState &state)
+{
+    // ================= AAAA15 =================
+    scanner.on(0x15, [&state](const LogPacket &pkt) {
+        const quint32 t = LogContainer::packetTime(pkt.data, pkt.length, 0x15);
+        if (t == LogContainer::NO_TIME)
+            return;
+
+        // Relay bitmap from byte 21 on. Desktop: byte swap, then
+        // MSB-first bits, so relay i is bit (7 - i%8) of the byte
+        // (i/8) counted from the end of the packet.
+        const quint8 *bitmap = pkt.data + 21;
+        const int bitmapBytes = qMax(0, pkt.length - 21);
+
+        QBitArray bits(bitmapBytes * 8);
+        for (int i = 0; i < bits.size(); ++i)
+            if ((bitmap[bitmapBytes - 1 - i / 8] >> (7 - i % 8)) & 1)
+                bits.setBit(i);
+
+        RelayStationLog &s = state.stations[(pkt.data[7] << 8) | pkt.data[8]];
+
+        // Unchanged bitmaps share the previous snapshot's storage
+        if (!s.snapshots.isEmpty() && s.snapshots.last() == bits)
+            bits = s.snapshots.last();
+
+        RelayEntry e;
+        e.time = t;
+        e.snapshot = s.snapshots.size();
+        s.snapshots.append(bits);
+        s.entries.append(e);
+    });
+
+    // ================= AAAA16 =================
+    scanner.on(0x16, [&state](const LogPacket &pkt) {
+        if (pkt.length < 20)
+            return;
+
+        const quint32 t = LogContainer::packetTime(pkt.data, pkt.length, 0x16);
+        if (t == LogContainer::NO_TIME)
+            return;
+
+        const quint8 *d = pkt.data;
+        RelayStationLog &s = state.stations[(d[7] << 8) | d[8]];
+
+        RelayEntry e;
+        e.time = t;
+        e.firstDelta = s.deltas.size();
+
+        // Relay address (2 bytes), then status
+        const int eventCount = d[18];
+        for (int i = 0; i < eventCount && (21 + 3*i + 1) < pkt.length; ++i) {
+            RelayDelta delta;
+            delta.address = quint16((d[19 + 3*i] << 8) | d[20 + 3*i]);
+            delta.set = d[21 + 3*i] == 0x01;
+            s.deltas.append(delta);
+        }
+
+        e.deltaCount = s.deltas.size() - e.firstDelta;
+        s.entries.append(e);
+    });
+}
+
+QSharedPointer<const RelayDayState> RelayStateStore::day(const QString &path)
+{
+    return stateCache().day(path, buildDay);
+}
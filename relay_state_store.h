@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/*
+ * Relay state of each station in a day file, kept as snapshots plus
+ * deltas instead of one row per relay and packet.
+ *
+ * AAAA15 full bitmaps become bitsets in relay order (bit i = relay i of
+ * the station's relay list, desktop bit order); a bitmap equal to the
+ * station's previous one shares its storage. AAAA16 change events are
+ * kept as (relay address, new state) deltas. Every packet leaves one
+ * entry in file order, so reports walk packets and changes, and the
+ * state at any instant is the last snapshot with the deltas after it.
+ *
+ * Times are LogContainer::packetTime() seconds. Days are cached in a
+ * DayCache (day_cache.h).
+ */
+
+struct RelayDelta
+{
+    quint16 address = 0;
+    bool set = false;              // raw status bit (0x01)
+};
+
+struct RelayEntry
+{
+    quint32 time = 0;
+    qint32 snapshot = -1;          // AAAA15: index into snapshots
+    qint32 firstDelta = 0;         // AAAA16: deltas [first, first + count)
+    qint32 deltaCount = 0;
+};
+
+struct RelayStationLog
+{
+    QVector<RelayEntry> entries;   // file order
+    QVector<QBitArray> snapshots;
+    QVector<RelayDelta> deltas;
+
+    // State at 'time' (inclusive): bit i = raw bit of relay i. 'indexOf'
+    // maps relay address -> relay index. Empty if no snapshot precedes it.
+    QBitArray stateAt(quint32 time, const QHash<int, int> &indexOf) const;
+
+    // True when an AAAA15 of this station lies in [fromTime, toTime]
+    bool hasSnapshotIn(quint32 fromTime, quint32 toTime) const;
+};
+
+struct RelayDayState
+{
+    QHash<int, RelayStationLog> stations;   // raw station id (bytes 7..8)
+
+    qint64 memoryCost() const;
+    void squeeze();
+};
+
+class RelayStateStore
+{
+public:
+    // Relay state of one day file (hex path), built on first use. Null
+    // when the file cannot be read.
+    static QSharedPointer<const RelayDayState> day(const QString &path);
+
+    // Upper bound for cached days (bytes)
+    static void setCacheBudget(qint64 bytes);
+};
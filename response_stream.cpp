@@ -0,0 +1,166 @@
+#include "response_stream.h"
+
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <cstring>
+
+struct RowStreamState
+{
+    QMutex mutex;
+    QWaitCondition drained;
+
+    QByteArray buffer;
+    qsizetype readPos = 0;     // bytes of 'buffer' already read
+    bool finished = false;     // producer is done
+    bool closed = false;       // device deleted (response done or client gone)
+
+    RowStreamNotifier *notifier = nullptr;
+
+    qsizetype available() const { return buffer.size() - readPos; }
+
+    ~RowStreamState()
+    {
+        // The last reference may be dropped on the producer thread
+        if (notifier)
+            notifier->deleteLater();
+    }
+};
+
+// =====================================================
+// DEVICE (server thread)
+// =====================================================
+
+QSharedPointer<RowStreamWriter> RowStream::open(QHttpServerResponder &responder,
+                                                QHttpHeaders headers)
+{
+    QSharedPointer<RowStreamState> state(new RowStreamState);
+    state->notifier = new RowStreamNotifier;
+
+    auto *device = new RowStream(state);
+    device->QIODevice::open(QIODevice::ReadOnly);
+
+    connect(state->notifier, &RowStreamNotifier::more,
+            device, &QIODevice::readyRead);
+    connect(state->notifier, &RowStreamNotifier::finished,
+            device, &QIODevice::readChannelFinished);
+
+    headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentType,
+                            "application/x-ndjson");
+
+    // The responder owns the device and reads it as the socket drains
+    responder.write(device, headers, QHttpServerResponder::StatusCode::Ok);
+
+    return QSharedPointer<RowStreamWriter>(new RowStreamWriter(state));
+}
+
+RowStream::RowStream(QSharedPointer<RowStreamState> state)
+    : m_state(std::move(state))
+{
+}
+
+RowStream::~RowStream()
+{
+    QMutexLocker lock(&m_state->mutex);
+    m_state->closed = true;
+    m_state->drained.wakeAll();
+}
+
+qint64 RowStream::bytesAvailable() const
+{
+    QMutexLocker lock(&m_state->mutex);
+    return m_state->available() + QIODevice::bytesAvailable();
+}
+
+bool RowStream::atEnd() const
+{
+    QMutexLocker lock(&m_state->mutex);
+    return m_state->finished && m_state->available() == 0 &&
+           QIODevice::bytesAvailable() == 0;
+}
+
+qint64 RowStream::readData(char *data, qint64 maxSize)
+{
+    QMutexLocker lock(&m_state->mutex);
+    RowStreamState &s = *m_state;
+
+    const qint64 n = qMin<qint64>(maxSize, s.available());
+    if (n == 0)
+        return s.finished ? -1 : 0;
+
+    std::memcpy(data, s.buffer.constData() + s.readPos, size_t(n));
+    s.readPos += n;
+
+    // Drop what was read once it is most of the buffer
+    if (s.readPos > s.buffer.size() / 2) {
+        s.buffer.remove(0, s.readPos);
+        s.readPos = 0;
+    }
+
+    s.drained.wakeAll();
+    return n;
+}
+
+// =====================================================
+// WRITER (producer thread)
+// =====================================================
+
+RowStreamWriter::RowStreamWriter(QSharedPointer<RowStreamState> state)
+    : m_state(std::move(state))
+{
+    m_pending.reserve(CHUNK);
+}
+
+RowStreamWriter::~RowStreamWriter()
+{
+    if (!m_finished)
+        finish();
+}
+
+bool RowStreamWriter::write(const QJsonObject &row)
+{
+    m_pending += QJsonDocument(row).toJson(QJsonDocument::Compact);
+    m_pending += '\n';
+
+    return m_pending.size() < CHUNK || flush();
+}
+
+bool RowStreamWriter::flush()
+{
+    {
+        QMutexLocker lock(&m_state->mutex);
+        RowStreamState &s = *m_state;
+
+        // Flow control: wait for the socket side to catch up
+        while (!s.closed && s.available() > HIGH_WATER)
+            s.drained.wait(&s.mutex);
+
+        if (s.closed) {
+            m_pending.clear();
+            return false;
+        }
+
+        s.buffer += m_pending;
+    }
+
+    m_pending.clear();
+    emit m_state->notifier->more();
+    return true;
+}
+
+void RowStreamWriter::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    if (!m_pending.isEmpty() && !flush())
+        return;
+
+    {
+        QMutexLocker lock(&m_state->mutex);
+        m_state->finished = true;
+    }
+
+    emit m_state->notifier->more();
+    emit m_state->notifier->finished();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHttpHeaders>
+#include <QHttpServerResponder>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+/*
+ * NDJSON (one JSON object per line) response written while the rows are
+ * still being decoded.
+ *
+ * RowStream::open() answers the request with a sequential QIODevice;
+ * QHttpServerResponder sends it with chunked transfer encoding and only
+ * reads more once the socket has drained. A worker thread writes rows
+ * through the returned RowStreamWriter. The writer blocks while more than
+ * HIGH_WATER bytes are waiting to be read, so memory stays flat however
+ * large the range is, and a slow client slows the producer down instead.
+ * Once the client is gone writes fail and the producer stops.
+ */
+
+struct RowStreamState;
+
+class RowStreamWriter
+{
+public:
+    static constexpr qsizetype CHUNK = 64 * 1024;
+    static constexpr qsizetype HIGH_WATER = 1024 * 1024;
+
+    explicit RowStreamWriter(QSharedPointer<RowStreamState> state);
+    ~RowStreamWriter();
+
+    // Append one line; false once the client is gone
+    bool write(const QJsonObject &row);
+
+    // Send what is pending and end the response
+    void finish();
+
+private:
+    bool flush();
+
+    QSharedPointer<RowStreamState> m_state;
+    QByteArray m_pending;
+    bool m_finished = false;
+};
+
+// Emits from the producer thread; lives on the server thread
+class RowStreamNotifier : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void more();
+    void finished();
+};
+
+class RowStream : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    // Start an NDJSON response on 'responder'; rows go through the writer
+    static QSharedPointer<RowStreamWriter> open(QHttpServerResponder &responder,
+                                                QHttpHeaders headers);
+
+    ~RowStream() override;
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+    bool atEnd() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    explicit RowStream(QSharedPointer<RowStreamState> state);
+
+    QSharedPointer<RowStreamState> m_state;
+};
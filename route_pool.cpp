@@ -0,0 +1,234 @@
+#include "route_pool.h"
+#include "response_stream.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHttpHeaders>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtGlobal>
+#include <memory>
+
+#define JNUM(x) QJsonValue(static_cast<qint64>(x))
+
+// =====================================================
+// POOL STATE
+// =====================================================
+
+struct RoutePoolState
+{
+    const char* name;
+    QThreadPool pool;
+
+    QMutex mutex;
+    QList<qint64> waiting;   // enqueue times (ms), oldest first
+    int active = 0;
+    int maxQueue = 64;
+    qint64 completed = 0;
+    qint64 rejected = 0;
+    qint64 waitTotalMs = 0;
+    qint64 waitMaxMs = 0;
+
+    RoutePoolState(const char* poolName, const char* threadsEnv, int threads,
+                   const char* queueEnv)
+        : name(poolName)
+    {
+        const int t = qEnvironmentVariableIntValue(threadsEnv);
+        pool.setMaxThreadCount(t > 0 ? t : threads);
+
+        // Idle threads are kept, with their DB connection (db_pool.h)
+        pool.setExpiryTimeout(-1);
+
+        const int q = qEnvironmentVariableIntValue(queueEnv);
+        if (q > 0)
+            maxQueue = q;
+    }
+};
+
+static qint64 nowMs()
+{
+    static QElapsedTimer clock = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return clock.elapsed();
+}
+
+static RoutePoolState& poolState(RoutePool::Class cls)
+{
+    static RoutePoolState meta("meta", "META_WORKERS", 2, "META_QUEUE");
+    static RoutePoolState scan("scan", "SCAN_WORKERS",
+                               qMax(2, QThread::idealThreadCount() / 2), "SCAN_QUEUE");
+    return cls == RoutePool::Meta ? meta : scan;
+}
+
+// =====================================================
+// ADMISSION / ACCOUNTING
+// =====================================================
+
+static QHttpHeaders corsHeaders()
+{
+    QHttpHeaders headers;
+    headers.append("Access-Control-Allow-Origin", "*");
+    headers.append("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
+    headers.append("Access-Control-Allow-Headers", "*");
+    return headers;
+}
+
+static QHttpServerResponse busyResponse()
+{
+    QHttpServerResponse res(
+        QJsonObject{{"success", false}, {"error", "Server busy, retry later"}},
+        QHttpServerResponse::StatusCode::ServiceUnavailable);
+
+    QHttpHeaders headers = corsHeaders();
+    headers.append("Retry-After", "1");
+    res.setHeaders(headers);
+    return res;
+}
+
+// Queue a request unless the queue is full
+static bool admit(RoutePoolState& s, qint64 enqueued)
+{
+    QMutexLocker lock(&s.mutex);
+    if (s.waiting.size() >= s.maxQueue) {
+        s.rejected++;
+        return false;
+    }
+    s.waiting.append(enqueued);
+    return true;
+}
+
+static void started(RoutePoolState& s, qint64 enqueued)
+{
+    const qint64 waited = nowMs() - enqueued;
+
+    QMutexLocker lock(&s.mutex);
+    s.waiting.removeOne(enqueued);
+    s.active++;
+    s.waitTotalMs += waited;
+    s.waitMaxMs = qMax(s.waitMaxMs, waited);
+}
+
+static void done(RoutePoolState& s)
+{
+    QMutexLocker lock(&s.mutex);
+    s.active--;
+    s.completed++;
+}
+
+// =====================================================
+// RUN
+// =====================================================
+
+QFuture<QHttpServerResponse> RoutePool::ready(QHttpServerResponse response)
+{
+    return QtFuture::makeReadyValueFuture(std::move(response));
+}
+
+QFuture<QHttpServerResponse> RoutePool::run(Class cls,
+                                            std::function<QHttpServerResponse()> work)
+{
+    RoutePoolState& s = poolState(cls);
+    const qint64 enqueued = nowMs();
+
+    if (!admit(s, enqueued))
+        return ready(busyResponse());
+
+    return QtConcurrent::run(&s.pool, [&s, enqueued, work = std::move(work)]() {
+        started(s, enqueued);
+        QHttpServerResponse res = work();
+        done(s);
+        return res;
+    });
+}
+
+void RoutePool::respond(Class cls, QHttpServerResponder& responder,
+                        std::function<QHttpServerResponse()> work)
+{
+    RoutePoolState& s = poolState(cls);
+    const qint64 enqueued = nowMs();
+
+    if (!admit(s, enqueued)) {
+        responder.sendResponse(busyResponse());
+        return;
+    }
+
+    // Answered from the server thread once the work is done
+    auto r = std::make_shared<QHttpServerResponder>(std::move(responder));
+
+    s.pool.start([&s, enqueued, r, work = std::move(work)]() {
+        started(s, enqueued);
+        auto res = std::make_shared<QHttpServerResponse>(work());
+        done(s);
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [r, res]() {
+            r->sendResponse(*res);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void RoutePool::stream(Class cls, QHttpServerResponder& responder,
+                       std::function<QJsonObject(const RowSink&)> produce)
+{
+    RoutePoolState& s = poolState(cls);
+    const qint64 enqueued = nowMs();
+
+    if (!admit(s, enqueued)) {
+        responder.sendResponse(busyResponse());
+        return;
+    }
+
+    QSharedPointer<RowStreamWriter> writer = RowStream::open(responder, corsHeaders());
+
+    s.pool.start([&s, enqueued, writer, produce = std::move(produce)]() {
+        started(s, enqueued);
+
+        const RowSink sink = [&writer](const QJsonObject& row) {
+            return writer->write(row);
+        };
+
+        // Rows, then the status object as the last line
+        const QJsonObject status = produce(sink);
+        writer->write(status);
+        writer->finish();
+
+        done(s);
+    });
+}
+
+// =====================================================
+// STATS
+// =====================================================
+
+QJsonObject RoutePool::stats()
+{
+    QJsonObject out;
+    const qint64 now = nowMs();
+
+    for (Class cls : {Meta, Scan}) {
+        RoutePoolState& s = poolState(cls);
+        QMutexLocker lock(&s.mutex);
+
+        const qint64 taken = s.completed + s.active;
+
+        out[s.name] = QJsonObject{
+            {"threads", s.pool.maxThreadCount()},
+            {"active", s.active},
+            {"queued", int(s.waiting.size())},
+            {"maxQueue", s.maxQueue},
+            {"oldestWaitMs", JNUM(s.waiting.isEmpty() ? 0 : now - s.waiting.first())},
+            {"avgWaitMs", JNUM(taken > 0 ? s.waitTotalMs / taken : 0)},
+            {"maxWaitMs", JNUM(s.waitMaxMs)},
+            {"completed", JNUM(s.completed)},
+            {"rejected", JNUM(s.rejected)}
+        };
+    }
+
+    return {{"success", true}, {"pools", out}};
+}
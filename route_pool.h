@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QFuture>
+#include <QHttpServerResponder>
+#include <QHttpServerResponse>
+#include <QJsonObject>
+#include <functional>
+
+#include "row_sink.h"
+
+/*
+ * Worker pools for the HTTP route handlers.
+ *
+ * Handlers parse the request on the server thread and hand the actual
+ * work to a pool, returning a QFuture the server answers from when it
+ * completes, so a long report never blocks /health or other clients.
+ *
+ * Two route classes get separate pools so they cannot starve each other:
+ *   Meta - cheap lookups (meta, station lists)
+ *   Scan - log scans and reports
+ *
+ * Each pool has a bounded thread count and queue; a request that finds
+ * the queue full is answered 503 at once. Sizes come from META_WORKERS /
+ * SCAN_WORKERS and META_QUEUE / SCAN_QUEUE when set. Queue depth and
+ * wait times are reported by stats() (/api/server/pools).
+ *
+ * Database routes may run on either pool: DbPool (db_pool.h) gives every
+ * thread its own connection.
+ */
+
+class RoutePool
+{
+public:
+    enum Class { Meta, Scan };
+
+    // Run 'work' on the pool of 'cls'
+    static QFuture<QHttpServerResponse> run(Class cls,
+                                            std::function<QHttpServerResponse()> work);
+
+    // Already answered (validation errors and the like)
+    static QFuture<QHttpServerResponse> ready(QHttpServerResponse response);
+
+    // Same as run() for routes that take a responder (those that can
+    // also stream); the response is sent from the server thread
+    static void respond(Class cls, QHttpServerResponder &responder,
+                        std::function<QHttpServerResponse()> work);
+
+    // NDJSON response (see response_stream.h): produce() runs on the pool
+    // and hands each row to the sink; the object it returns is sent as
+    // the last line
+    static void stream(Class cls, QHttpServerResponder &responder,
+                       std::function<QJsonObject(const RowSink &)> produce);
+
+    // Threads, queue depth and wait times of both pools
+    static QJsonObject stats();
+};
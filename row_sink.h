@@ -0,0 +1,9 @@
+#pragma once
+
+#include <QJsonObject>
+#include <functional>
+
+// Receives report rows one at a time, as they are decoded, instead of a
+// QJsonArray holding them all (see response_stream.h). Returns false once
+// the consumer is gone (client disconnected); the producer should stop.
+using RowSink = std::function<bool(const QJsonObject &row)>;
@@ -0,0 +1,83 @@
+#include "sql_row_mapper.h"
+
+#include <QDateTime>
+#include <QSqlField>
+#include <QVariant>
+
+SqlRowMapper::SqlRowMapper(const QSqlRecord &rec)
+{
+    m_columns.reserve(rec.count());
+    for (int i = 0; i < rec.count(); ++i) {
+        const QSqlField f = rec.field(i);
+        m_columns.append({f.name(), i, typeOf(f.metaType())});
+    }
+}
+
+SqlRowMapper::Type SqlRowMapper::typeOf(QMetaType type)
+{
+    switch (type.id()) {
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        return Integer;
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return Real;
+    case QMetaType::Bool:
+        return Bool;
+    case QMetaType::QDateTime:
+        return DateTime;
+    case QMetaType::QDate:
+        return Date;
+    case QMetaType::QTime:
+        return Time;
+    default:
+        return Text;
+    }
+}
+
+QJsonObject SqlRowMapper::map(const QSqlQuery &q) const
+{
+    QJsonObject row;
+
+    for (const Column &c : m_columns) {
+        const QVariant v = q.value(c.index);
+        if (v.isNull()) {
+            row.insert(c.key, QJsonValue::Null);
+            continue;
+        }
+
+        switch (c.type) {
+        case Integer:
+            row.insert(c.key, v.toLongLong());
+            break;
+        case Real:
+            row.insert(c.key, v.toDouble());
+            break;
+        case Bool:
+            row.insert(c.key, v.toBool());
+            break;
+        case DateTime:
+            row.insert(c.key, v.toDateTime().toString(Qt::ISODateWithMs));
+            break;
+        case Date:
+            row.insert(c.key, v.toDate().toString(Qt::ISODate));
+            break;
+        case Time:
+            row.insert(c.key, v.toTime().toString(Qt::ISODateWithMs));
+            break;
+        case Text:
+            row.insert(c.key, v.toString());
+            break;
+        }
+    }
+    return row;
+}
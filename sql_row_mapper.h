@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QString>
+
+/*
+ * QSqlQuery rows to JSON objects without per-row lookups.
+ *
+ * Column names, positions and types are read from the result record
+ * once, after exec(); map() then walks the resolved slots and converts
+ * each value by its column type: integers and reals become JSON numbers,
+ * booleans booleans, dates and times ISO strings, NULL null. Nothing
+ * passes through a string unless the column is text.
+ */
+
+class SqlRowMapper
+{
+public:
+    enum Type { Text, Integer, Real, Bool, DateTime, Date, Time };
+
+    // Every column of 'rec', keyed by its field name
+    explicit SqlRowMapper(const QSqlRecord &rec);
+
+    int columnCount() const { return int(m_columns.size()); }
+
+    QJsonObject map(const QSqlQuery &q) const;
+
+private:
+    struct Column
+    {
+        QString key;
+        int index;
+        Type type;
+    };
+
+    static Type typeOf(QMetaType type);
+
+    QList<Column> m_columns;
+};
@@ -0,0 +1,32 @@
+QT += core sql concurrent testlib
+QT -= gui
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+TARGET = tst_log_ingest
+
+INCLUDEPATH += $$PWD/../.. $$PWD/../../config
+
+SOURCES += \
+    tst_log_ingest.cpp \
+    ../../crc32.cpp \
+    ../../db_pool.cpp \
+    ../../fault_rollup.cpp \
+    ../../hex_decoder.cpp \
+    ../../kavach_schema.cpp \
+    ../../log_container.cpp \
+    ../../log_index.cpp \
+    ../../log_ingest.cpp \
+    ../../log_parallel.cpp \
+    ../../log_scanner.cpp \
+    ../../lvk_fault_packet.cpp \
+    ../../lvk_fault_parser.cpp \
+    ../../lvk_pos_info_parser.cpp \
+    ../../config/stations_config.cpp
+
+HEADERS += \
+    ../../crc32.h \
+    ../../db_pool.h \
+    ../../fault_rollup.h \
+    ../../log_ingest.h \
+    ../../log_scanner.h
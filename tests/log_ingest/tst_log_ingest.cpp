@@ -0,0 +1,208 @@
+#include "crc32.h"
+#include "log_ingest.h"
+#include "log_scanner.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QtTest>
+
+/*
+ * LogIngest against a QSQLITE file (Options::connection): one day file
+ * of AAAA12 and AAAA19 frames is ingested, ingested again, then grown
+ * and ingested once more. Re-runs must not duplicate rows, and
+ * log_ingest_days must follow the committed rows.
+ */
+
+namespace {
+
+const char *const CONNECTION = "tst_log_ingest";
+const QDate DAY(2025, 3, 14);
+
+// AAAA12 with a regular radio packet, frame number 'n'
+QByteArray posInfoFrame(int n)
+{
+    QByteArray f(80, '\0');
+    auto *d = reinterpret_cast<quint8 *>(f.data());
+
+    d[0] = 0xAA; d[1] = 0xAA;
+    d[2] = 0x12;
+    d[3] = 0; d[4] = quint8(f.size() - 2);
+    d[5] = quint8(n >> 8); d[6] = quint8(n);
+    d[7] = 0x00; d[8] = 0x2A;
+    d[12] = quint8(DAY.day()); d[13] = quint8(DAY.month()); d[14] = quint8(DAY.year() - 2000);
+    d[15] = quint8(n / 3600 % 24); d[16] = quint8(n / 60 % 60); d[17] = quint8(n % 60);
+    d[18] = 0xF1;
+
+    // Packet type 0xA, then a 17-bit frame number after the 7-bit length
+    d[21] = 0xA0;
+    d[22] = quint8(n >> 12);
+    d[23] = quint8(n >> 4);
+    d[24] = quint8(n << 4);
+    return f;
+}
+
+// AAAA19 with one fault; 'crcOk' false corrupts the CRC
+QByteArray faultFrame(int n, bool crcOk = true)
+{
+    QByteArray f(29, '\0');
+    auto *d = reinterpret_cast<quint8 *>(f.data());
+
+    d[0] = 0xAA; d[1] = 0xAA;
+    d[2] = 0x19;
+    d[3] = 0; d[4] = quint8(f.size() - 2);
+    d[5] = quint8(n >> 8); d[6] = quint8(n);
+    d[9] = 0x2A;                          // kavach subsystem id (24 bit)
+    d[12] = 1;                            // system version
+    d[13] = quint8(DAY.day()); d[14] = quint8(DAY.month()); d[15] = quint8(DAY.year() - 2000);
+    d[16] = 10; d[17] = quint8(n % 60); d[18] = 0;
+    d[19] = 0x11;                         // stationary
+    d[20] = 1;                            // one fault
+    d[21] = 0x03; d[22] = 1; d[23] = 0x12; d[24] = quint8(n);
+
+    quint32 crc = Crc32::msbFirst(d + 2, f.size() - 6);
+    if (!crcOk)
+        crc = ~crc;
+    d[25] = quint8(crc >> 24); d[26] = quint8(crc >> 16);
+    d[27] = quint8(crc >> 8);  d[28] = quint8(crc);
+    return f;
+}
+
+void appendLines(const QString &path, const QList<QByteArray> &frames)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::Append));
+    for (const QByteArray &f : frames)
+        file.write(f.toHex().toUpper() + "\r\n");
+}
+
+qint64 scalar(const QString &sql)
+{
+    QSqlQuery q(QSqlDatabase::database(CONNECTION));
+    if (!q.exec(sql) || !q.next())
+        return -1;
+    return q.value(0).toLongLong();
+}
+
+QJsonObject ingest(const QString &path)
+{
+    LogIngest::Options options;
+    options.connection = CONNECTION;
+    options.batchRows = 100;
+
+    LogIngest ingest(options);
+    ingest.ingestDays({path});
+    return ingest.finish();
+}
+
+} // namespace
+
+class TestLogIngest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void firstRunWritesEveryRow();
+    void rerunWritesNothing();
+    void grownDayWritesOnlyNewRows();
+
+private:
+    void checkProgress(qint64 movement, qint64 fault);
+
+    QTemporaryDir m_dir;
+    QString m_day;
+};
+
+void TestLogIngest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION);
+    db.setDatabaseName(m_dir.filePath("ingest.sqlite"));
+    QVERIFY(db.open());
+
+    m_day = LogScanner::dayFilePath(m_dir.path(), DAY);
+
+    QList<QByteArray> frames;
+    for (int n = 0; n < 250; ++n) {
+        frames.append(posInfoFrame(n));
+        if (n % 50 == 0)
+            frames.append(faultFrame(n));
+    }
+    frames.append(faultFrame(999, false));
+    appendLines(m_day, frames);
+}
+
+void TestLogIngest::cleanupTestCase()
+{
+    QSqlDatabase::database(CONNECTION).close();
+    QSqlDatabase::removeDatabase(CONNECTION);
+}
+
+void TestLogIngest::checkProgress(qint64 movement, qint64 fault)
+{
+    const QString file = QFileInfo(m_day).absoluteFilePath();
+
+    QSqlQuery q(QSqlDatabase::database(CONNECTION));
+    q.prepare("SELECT movement_rows, fault_rows FROM log_ingest_days WHERE log_file = ?");
+    q.addBindValue(file);
+    QVERIFY(q.exec());
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toLongLong(), movement);
+    QCOMPARE(q.value(1).toLongLong(), fault);
+    QVERIFY(!q.next());
+
+    QCOMPARE(scalar("SELECT COUNT(*) FROM loco_movement_logs"), movement);
+    QCOMPARE(scalar("SELECT COUNT(*) FROM loco_fault_logs"), fault);
+}
+
+void TestLogIngest::firstRunWritesEveryRow()
+{
+    const QJsonObject res = ingest(m_day);
+
+    QVERIFY(res["success"].toBool());
+    QCOMPARE(res["rowsWritten"].toInteger(), qint64(255));
+    QCOMPARE(res["rowsSkipped"].toInteger(), qint64(0));
+    QCOMPARE(res["crcRejected"].toInteger(), qint64(1));
+
+    checkProgress(250, 5);
+}
+
+void TestLogIngest::rerunWritesNothing()
+{
+    const QJsonObject res = ingest(m_day);
+
+    QVERIFY(res["success"].toBool());
+    QCOMPARE(res["rowsWritten"].toInteger(), qint64(0));
+    QCOMPARE(res["rowsSkipped"].toInteger(), qint64(255));
+
+    checkProgress(250, 5);
+}
+
+void TestLogIngest::grownDayWritesOnlyNewRows()
+{
+    QList<QByteArray> frames;
+    for (int n = 250; n < 300; ++n)
+        frames.append(posInfoFrame(n));
+    frames.append(faultFrame(300));
+    appendLines(m_day, frames);
+
+    const QJsonObject res = ingest(m_day);
+
+    QVERIFY(res["success"].toBool());
+    QCOMPARE(res["rowsWritten"].toInteger(), qint64(51));
+    QCOMPARE(res["rowsSkipped"].toInteger(), qint64(255));
+
+    checkProgress(300, 6);
+
+    // Frame numbers of the movement rows are each written once
+    QCOMPARE(scalar("SELECT COUNT(DISTINCT frame_number) FROM loco_movement_logs"), qint64(300));
+}
+
+QTEST_GUILESS_MAIN(TestLogIngest)
+#include "tst_log_ingest.moc"
@@ -1,58 +1,45 @@
 #include "track_profile_graph_backend.h"
 
-#include <QFile>
 #include <QDate>
 #include <QSet>
 #include <QJsonArray>
 #include <iostream>
 
 #include "track_profile_config.h"
+#include "bit_reader.h"
+#include "kavach_schema.h"
+#include "log_parallel.h"
+#include "log_scanner.h"
+#include "day_summary_cache.h"
 
 /* =========================================================
-   HEX → BIN
+   REGULAR (1001) PAYLOAD BYTES AFTER A5C3
    ========================================================= */
-QString TrackProfileGraphBackend::hexToBin(const QString &hex)
+bool TrackProfileGraphBackend::regularPayload(const LogPacket &pkt, const quint8 *&p, qint64 &n)
 {
-    QString bin;
-    for (QChar c : hex)
+    for (int i = 0; i + 2 < pkt.length; ++i)
     {
-        bool ok;
-        int v = QString(c).toInt(&ok, 16);
-        if (ok)
-            bin += QString("%1").arg(v, 4, 2, QChar('0'));
+        if (pkt.data[i] != 0xA5 || pkt.data[i + 1] != 0xC3)
+            continue;
+
+        p = pkt.data + i + 2;
+        n = pkt.length - i - 2;
+        return (p[0] >> 4) == 0b1001;
     }
-    return bin;
+    return false;
 }
 
-/* =========================================================
-   READ BIN FILE (AAAA11)
-   ========================================================= */
-QStringList TrackProfileGraphBackend::readBinFile(const QString &filePath)
+// Points of one day file
+struct GraphPoints
 {
-    QFile file(filePath);
-    QStringList packets;
+    GraphSeries speed;
+    GraphSeries gradient;
+};
 
-    if (!file.open(QIODevice::ReadOnly))
-    {
-
-        return packets;
-    }
-
-    QString raw = file.readAll().toUpper();
-    raw.replace("\r", "");
-    raw.replace("\n", "");
-
-    raw.replace("AAAA11", "|AAAA11");
-    QStringList split = raw.split("|", Qt::SkipEmptyParts);
-
-    for (const QString &pkt : split)
-    {
-        if (pkt.startsWith("AAAA11"))
-            packets.append(pkt);
-    }
-
-
-    return packets;
+static QString directionName(qint64 dirBits)
+{
+    return (dirBits == 1) ? "Nominal" :
+               (dirBits == 2) ? "Reverse" : "NA";
 }
 
 /* =========================================================
@@ -87,58 +74,32 @@ QJsonObject TrackProfileGraphBackend::getMeta(
         return {{"success", false}};
     }
 
-    for (QDate d = from; d <= to; d = d.addDays(1))
-    {
-        QString binPath = cleanLogDir + "/" + d.toString("dd-MM-yy") + ".bin";
-
-
-        QStringList packets = readBinFile(binPath);
-
-        for (const QString &pkt : packets)
-        {
-            int a5c3 = pkt.indexOf("A5C3");
-            if (a5c3 < 0)
-            {
-
-                continue;
-            }
-
-            QString payloadHex = pkt.mid(a5c3 + 4);
-            QString payloadBin = hexToBin(payloadHex);
-
-            if (!payloadBin.startsWith("1001"))
-            {
+    // Merged from the per-day summaries, built concurrently on a miss
+    const auto summaries = LogParallel::mapDays<QSharedPointer<const DaySummary>>(
+        LogParallel::dayPaths(cleanLogDir, from, to), DaySummaryCache::day);
 
-                continue;
-            }
+    for (const QSharedPointer<const DaySummary> &day : summaries)
+    {
+        if (!day)
+            continue;
 
-            QString loco =
-                QString::number(payloadBin.mid(50, 20).toULongLong(nullptr, 2));
-            QString profile =
-                QString::number(payloadBin.mid(70, 4).toULongLong(nullptr, 2));
+        for (quint32 loco : day->locos)
+            locoSet.insert(QString::number(loco));
 
-            QString dirBits = payloadBin.mid(99, 2);
-            QString direction =
-                (dirBits == "01") ? "Nominal" :
-                    (dirBits == "10") ? "Reverse" : "NA";
+        for (quint32 profile : day->profiles)
+            profileSet.insert(QString::number(profile));
 
-            QString stationHex = pkt.mid(14, 4);
-            QString station =
-                QString::number(stationHex.toInt(nullptr, 16));
+        for (quint8 dir : day->directions)
+            directionSet.insert(directionName(dir));
 
-            locoSet.insert(loco);
-            // stationSet.insert(station);
+        for (int id : day->stations)
+        {
+            const QString station = QString::number(id);
             if (STATION_ID_TO_CODE.contains(station))
-            {
                 stationSet.insert(STATION_ID_TO_CODE.value(station));
-            }
-
-            directionSet.insert(direction);
-            profileSet.insert(profile);
         }
     }
 
-
     return {
         {"success", true},
         {"locos", QJsonArray::fromStringList(locoSet.values())},
@@ -151,14 +112,17 @@ QJsonObject TrackProfileGraphBackend::getMeta(
 /* =========================================================
    GRAPH DATA API
    ========================================================= */
-QJsonObject TrackProfileGraphBackend::getGraphData(
+// Speed and gradient points of one loco through 'station' (false for
+// an unknown station or bad dates)
+bool TrackProfileGraphBackend::collectSeries(
     const QString &locoId,
     const QString &station,
     const QString &direction,
-    const QString &profileId,
     const QString &fromDate,
     const QString &toDate,
-    const QString &logDir
+    const QString &logDir,
+    GraphSeries &speedGraph,
+    GraphSeries &gradientGraph
     )
 {
     QString cleanLogDir = logDir.trimmed();
@@ -175,7 +139,7 @@ QJsonObject TrackProfileGraphBackend::getGraphData(
 
     if (!STATION_RANGE_MAP.contains(stationCode))
     {
-        return {{"success", false}};
+        return false;
     }
 
 
@@ -185,9 +149,6 @@ QJsonObject TrackProfileGraphBackend::getGraphData(
     int startLoc = (direction == "Nominal") ? r.nominalStart : r.reverseStart;
     int endLoc   = (direction == "Nominal") ? r.nominalEnd   : r.reverseEnd;
 
-    QJsonArray speedGraph, gradientGraph;
-    bool hasData = false;
-
     QString fromClean = fromDate.left(10);
     QString toClean   = toDate.left(10);
 
@@ -199,83 +160,151 @@ QJsonObject TrackProfileGraphBackend::getGraphData(
     if (!from.isValid() || !to.isValid())
     {
 
-        return {{"success", false}};
+        return false;
     }
 
-    for (QDate d = from; d <= to; d = d.addDays(1))
+    auto onPacket = [&](const LogPacket &pkt, GraphPoints &points)
     {
-        QString binPath = cleanLogDir + "/" + d.toString("dd-MM-yy") + ".bin";
+        GraphSeries &speedGraph = points.speed;
+        GraphSeries &gradientGraph = points.gradient;
 
+        const quint8 *p;
+        qint64 n;
+        if (!regularPayload(pkt, p, n)) return;
 
+        auto bits = [&](qint64 pos, int len) {
+            return int(BitReader::extract(p, n, pos, len));
+        };
 
-        QStringList packets = readBinFile(binPath);
+        if (QString::number(KavachSchema::project(p, n, KavachSchema::REGULAR_DEST_LOCO_ID)) != locoId)
+            return;
 
-        for (const QString &pkt : packets)
+        QString parsedDir = directionName(
+            KavachSchema::project(p, n, KavachSchema::REGULAR_PKT_DIRECTION));
+        if (parsedDir != direction) return;
+
+        int pos = KavachSchema::REGULAR_HEADER_BITS;
+
+        int sspLen = bits(pos+4,7);
+        sspLen = (sspLen+1)*8;
+
+        // Entries stay inside the sub-packet even if the count disagrees
+        int cnt = bits(pos+11,5);
+        for(int i=0;i<cnt && 16+21*i+21 <= sspLen;i++)
         {
-            int a5c3 = pkt.indexOf("A5C3");
-            if (a5c3 < 0) continue;
+            int dist = bits(pos+16+21*i,15);
+            int spd  = bits(pos+32+21*i,6);
 
-            QString payloadBin = hexToBin(pkt.mid(a5c3 + 4));
-            if (!payloadBin.startsWith("1001")) continue;
+            if (spd >= 1 && spd <= 50)
+            {
+                speedGraph.append(dist, spd * 5);
+            }
 
-            if (QString::number(payloadBin.mid(50,20).toULongLong(nullptr,2)) != locoId)
-                continue;
+        }
+        pos += sspLen;
 
-            QString dirBits = payloadBin.mid(99,2);
-            QString parsedDir = (dirBits=="01")?"Nominal":(dirBits=="10")?"Reverse":"NA";
-            if (parsedDir != direction) continue;
+        int gLen = bits(pos+4,7);
+        gLen = (gLen+1)*8;
 
-            int pos = 104;
+        int gCnt = bits(pos+11,5);
 
-            int sspLen = payloadBin.mid(pos+4,7).toULongLong(nullptr,2);
-            sspLen = (sspLen+1)*8;
-            QString ssp = payloadBin.mid(pos, sspLen);
+        for(int i=0;i<gCnt && 16+21*i+21 <= gLen;i++)
+        {
+            int dist = bits(pos+16+21*i,15);
+            int val  = bits(pos+32+21*i,5);
 
-            int cnt = ssp.mid(11,5).toULongLong(nullptr,2);
-            for(int i=0;i<cnt;i++)
+            if (val > 0 && val <= 30)
             {
-                int dist = ssp.mid(16+21*i,15).toULongLong(nullptr,2);
-                int spd  = ssp.mid(32+21*i,6).toULongLong(nullptr,2);
-
-                if (spd >= 1 && spd <= 50)
-                {
-                    QJsonObject speedPoint;
-                    speedPoint["x"] = dist;
-                    speedPoint["y"] = spd * 5;
-                    speedGraph.append(speedPoint);
-                    hasData = true;
-                }
-
+                gradientGraph.append(dist, 1000 / val);
             }
-            pos += sspLen;
 
-            int gLen = payloadBin.mid(pos+4,7).toULongLong(nullptr,2);
-            gLen = (gLen+1)*8;
-            QString grad = payloadBin.mid(pos,gLen);
-            int gCnt = grad.mid(11,5).toULongLong(nullptr,2);
+        }
+    };
 
-            for(int i=0;i<gCnt;i++)
-            {
-                int dist = grad.mid(16+21*i,15).toULongLong(nullptr,2);
-                int val  = grad.mid(32+21*i,5).toULongLong(nullptr,2);
-
-                if (val > 0 && val <= 30)
-                {
-                    QJsonObject gradPoint;
-                    gradPoint["x"] = dist;
-                    gradPoint["y"] = 1000 / val;
-                    gradientGraph.append(gradPoint);
-                    hasData = true;
-                }
+    bool locoOk = false;
+    const quint32 locoKey = locoId.toUInt(&locoOk);
 
-            }
+    // Days are decoded concurrently, points merged in date order
+    const QVector<GraphPoints> days = LogParallel::scanDays<GraphPoints>(
+        LogParallel::dayPaths(cleanLogDir, from, to),
+        [&](LogScanner &scanner, GraphPoints &points, int)
+    {
+        scanner.on(0x11, [&](const LogPacket &pkt) { onPacket(pkt, points); });
 
+        if (locoOk)
+        {
+            LogQuery query;
+            query.loco = locoKey;
+            scanner.where(query);
         }
+    });
+
+    for (const GraphPoints &day : days)
+    {
+        speedGraph.append(day.speed);
+        gradientGraph.append(day.gradient);
     }
+
+    return true;
+}
+
+QJsonObject TrackProfileGraphBackend::getGraphData(
+    const QString &locoId,
+    const QString &station,
+    const QString &direction,
+    const QString &,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &logDir,
+    const GraphReduction &reduce
+    )
+{
+    GraphSeries speedGraph, gradientGraph;
+    if (!collectSeries(locoId, station, direction, fromDate, toDate, logDir,
+                       speedGraph, gradientGraph))
+        return {{"success", false}};
+
+    speedGraph = reduce.apply(speedGraph);
+    gradientGraph = reduce.apply(gradientGraph);
+
+    const bool hasData = !speedGraph.isEmpty() || !gradientGraph.isEmpty();
+
     return {
         {"success", true},
         {"hasData", hasData},
-        {"speedGraph", speedGraph},
-        {"gradientGraph", gradientGraph}
+        {"speedGraph", GraphSeriesFormat::toJsonPoints(speedGraph)},
+        {"gradientGraph", GraphSeriesFormat::toJsonPoints(gradientGraph)}
     };
 }
+
+QCborMap TrackProfileGraphBackend::getGraphDataCbor(
+    const QString &locoId,
+    const QString &station,
+    const QString &direction,
+    const QString &,
+    const QString &fromDate,
+    const QString &toDate,
+    const QString &logDir,
+    const GraphReduction &reduce
+    )
+{
+    QCborMap res;
+
+    GraphSeries speedGraph, gradientGraph;
+    if (!collectSeries(locoId, station, direction, fromDate, toDate, logDir,
+                       speedGraph, gradientGraph))
+    {
+        res.insert(QStringLiteral("success"), false);
+        return res;
+    }
+
+    speedGraph = reduce.apply(speedGraph);
+    gradientGraph = reduce.apply(gradientGraph);
+
+    res.insert(QStringLiteral("success"), true);
+    res.insert(QStringLiteral("hasData"),
+               !speedGraph.isEmpty() || !gradientGraph.isEmpty());
+    res.insert(QStringLiteral("speedGraph"), GraphSeriesFormat::toCbor(speedGraph));
+    res.insert(QStringLiteral("gradientGraph"), GraphSeriesFormat::toCbor(gradientGraph));
+    return res;
+}
@@ -1,15 +1,17 @@
 #pragma once
 
+#include <QCborMap>
 #include <QJsonObject>
 #include <QString>
+#include <QtGlobal>
+
+#include "graph_series.h"
+
+struct LogPacket;
 
 class TrackProfileGraphBackend
 {
 public:
-    // helpers
-    static QString hexToBin(const QString &hex);
-    static QStringList readBinFile(const QString &filePath);
-
     // APIs
     static QJsonObject getMeta(
         const QString &logDir,
@@ -24,6 +26,36 @@ public:
         const QString &profileId,
         const QString &fromDate,
         const QString &toDate,
-        const QString &logDir
+        const QString &logDir,
+        const GraphReduction &reduce = {}   // maxPoints / downsample
+        );
+
+    // Same response as CBOR; each graph is {x, y} int32 typed arrays
+    // instead of a list of points (see graph_series.h)
+    static QCborMap getGraphDataCbor(
+        const QString &locoId,
+        const QString &station,
+        const QString &direction,
+        const QString &profileId,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &logDir,
+        const GraphReduction &reduce = {}   // maxPoints / downsample
+        );
+
+    // Regular (1001) payload bytes after the first A5C3 of an AAAA11
+    // packet; also used by DaySummaryCache
+    static bool regularPayload(const LogPacket &pkt, const quint8 *&p, qint64 &n);
+
+private:
+    static bool collectSeries(
+        const QString &locoId,
+        const QString &station,
+        const QString &direction,
+        const QString &fromDate,
+        const QString &toDate,
+        const QString &logDir,
+        GraphSeries &speedGraph,
+        GraphSeries &gradientGraph
         );
 };
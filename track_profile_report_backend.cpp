@@ -1,10 +1,12 @@
 #include "track_profile_report_backend.h"
 
-#include <QFile>
 #include <QDate>
 #include <QJsonArray>
 #include <QJsonObject>
 #include "track_profile_config.h"
+#include "bit_reader.h"
+#include "log_parallel.h"
+#include "log_scanner.h"
 
 QJsonObject TrackProfileReportBackend::getAllStations()
 {
@@ -30,41 +32,19 @@ QJsonObject TrackProfileReportBackend::getAllStations()
    LOW LEVEL HELPERS (DESKTOP + GRAPH PARITY)
    ========================================================= */
 
-static QString hexToBin(const QString &hex)
+// Payload (after A5 C3) of an AAAA11 packet, or false if it has none
+static bool payloadAfterA5C3(const LogPacket &pkt, const quint8 *&p, qint64 &n)
 {
-    QString bin;
-    for (QChar c : hex)
+    for (int i = 0; i + 2 < pkt.length; ++i)
     {
-        bool ok;
-        int v = QString(c).toInt(&ok, 16);
-        if (ok)
-            bin += QString("%1").arg(v, 4, 2, QChar('0'));
-    }
-    return bin;
-}
-
-static QStringList extractAAAA11Packets(const QString &filePath)
-{
-    QFile file(filePath);
-    QStringList packets;
-
-    if (!file.open(QIODevice::ReadOnly))
-        return packets;
-
-    QString raw = file.readAll().toUpper();
-    raw.replace("\r", "");
-    raw.replace("\n", "");
-
-    raw.replace("AAAA11", "|AAAA11");
-    QStringList split = raw.split("|", Qt::SkipEmptyParts);
-
-    for (const QString &pkt : split)
-    {
-        if (pkt.startsWith("AAAA11"))
-            packets.append(pkt);
+        if (pkt.data[i] == 0xA5 && pkt.data[i + 1] == 0xC3)
+        {
+            p = pkt.data + i + 2;
+            n = pkt.length - i - 2;
+            return true;
+        }
     }
-
-    return packets;
+    return false;
 }
 
 /* =========================================================
@@ -99,129 +79,126 @@ QJsonObject TrackProfileReportBackend::getReport(
     QString cleanLogDir = logDir;
     cleanLogDir.replace("\\", "/");
 
-    for (QDate d = from; d <= to; d = d.addDays(1))
+    auto onPacket = [&stations](const LogPacket &pkt, QJsonArray &rows)
     {
-        QString binPath =
-            cleanLogDir + "/" + d.toString("dd-MM-yy") + ".bin";
-
-        QStringList packets = extractAAAA11Packets(binPath);
+        if (pkt.length < 18)
+            return;
+
+        /* -------------------------
+           Must contain A5 C3
+           ------------------------- */
+        const quint8 *p;
+        qint64 n;
+        if (!payloadAfterA5C3(pkt, p, n))
+            return;
+
+        auto bits = [&](qint64 pos, int len) {
+            return BitReader::extract(p, n, pos, len);
+        };
 
-        for (const QString &pkt : packets)
+        /* -------------------------
+           Packet Type = 1001 (Track Profile)
+           ------------------------- */
+        if (bits(0, 4) != 0b1001)
+            return;
+
+        /* -------------------------
+           Station ID (from BIN)
+           ------------------------- */
+        QString stationId =
+            QString::number((pkt.data[7] << 8) | pkt.data[8]);
+
+        // Optional station filter (desktop behavior)
+        if (!stations.isEmpty() &&
+            !stations.contains(stationId))
         {
-            /* -------------------------
-               Must contain A5 C3
-               ------------------------- */
-            int a5c3 = pkt.indexOf("A5C3");
-            if (a5c3 < 0)
-                continue;
-
-            QString payloadHex = pkt.mid(a5c3 + 4);
-            QString payloadBin = hexToBin(payloadHex);
-
-            /* -------------------------
-               Packet Type = 1001 (Track Profile)
-               ------------------------- */
-            if (!payloadBin.startsWith("1001"))
-                continue;
-
-            /* -------------------------
-               Station ID (from BIN)
-               ------------------------- */
-            QString stationHex = pkt.mid(14, 4);
-            QString stationId =
-                QString::number(stationHex.toInt(nullptr, 16));
-
-            // Optional station filter (desktop behavior)
-            if (!stations.isEmpty() &&
-                !stations.contains(stationId))
-            {
-                continue;
-            }
-
-            /* -------------------------
-               Date (from MAIN packet)
-               ------------------------- */
-            int day   = pkt.mid(24, 2).toInt(nullptr, 16);
-            int month = pkt.mid(26, 2).toInt(nullptr, 16);
-            int year  = pkt.mid(28, 2).toInt(nullptr, 16);
-
-            QString date =
-                QString("%1-%2-%3")
-                    .arg(day,   2, 10, QChar('0'))
-                    .arg(month, 2, 10, QChar('0'))
-                    .arg(year,  2, 10, QChar('0'));
-
-            /* -------------------------
-               Time + Frame Number
-               ------------------------- */
-            int hh = pkt.mid(30, 2).toInt(nullptr, 16);
-            int mm = pkt.mid(32, 2).toInt(nullptr, 16);
-            int ss = pkt.mid(34, 2).toInt(nullptr, 16);
-
-            QString time =
-                QString("%1:%2:%3")
-                    .arg(hh, 2, 10, QChar('0'))
-                    .arg(mm, 2, 10, QChar('0'))
-                    .arg(ss, 2, 10, QChar('0'));
-
-            int frameNumber =
-                (hh * 3600) + (mm * 60) + ss + 1;
-
-
-            /* -------------------------
-               DEST LOCO ID (bits 49–68)
-               ------------------------- */
-            QString locoId =
-                QString::number(
-                    payloadBin.mid(49, 20)
-                        .toULongLong(nullptr, 2)
-                    );
-
-            /* -------------------------
-               PROFILE ID (bits 69–72)
-               ------------------------- */
-            QString profileId =
-                QString::number(
-                    payloadBin.mid(69, 4)
-                        .toULongLong(nullptr, 2)
-                    );
-
-            /* -------------------------
-               SUB PROFILE COUNT (bits 269–275)
-               ------------------------- */
-            QString subProfileCount =
-                QString::number(
-                    payloadBin.mid(269, 7)
-                        .toULongLong(nullptr, 2)
-                    );
-            /* -------------------------
-               PROFILE LENGTH (bits 264–270)
-               ------------------------- */
-            QString profileLength =
-                QString::number(
-                    payloadBin.mid(264, 7)
-                        .toULongLong(nullptr, 2)
-                    );
-
-            /* -------------------------
-               FINAL ROW (DESKTOP FORMAT)
-               ------------------------- */
-            QJsonObject row;
-            row["date"]              = date;
-            row["time"]              = time;
-            row["frameNumber"]       = frameNumber;
-            row["stationId"]         = stationId;
-            row["locoId"]            = locoId;
-            row["profileId"]         = profileId;
-            row["subProfileCount"]   = subProfileCount;
-            row["subProfileId"]      = "-";
-            row["startLocation"]     = "-";
-            row["profileLength"]     = profileLength;
+            return;
+        }
+
+        /* -------------------------
+           Date (from MAIN packet)
+           ------------------------- */
+        int day   = pkt.data[12];
+        int month = pkt.data[13];
+        int year  = pkt.data[14];
+
+        QString date =
+            QString("%1-%2-%3")
+                .arg(day,   2, 10, QChar('0'))
+                .arg(month, 2, 10, QChar('0'))
+                .arg(year,  2, 10, QChar('0'));
+
+        /* -------------------------
+           Time + Frame Number
+           ------------------------- */
+        int hh = pkt.data[15];
+        int mm = pkt.data[16];
+        int ss = pkt.data[17];
+
+        QString time =
+            QString("%1:%2:%3")
+                .arg(hh, 2, 10, QChar('0'))
+                .arg(mm, 2, 10, QChar('0'))
+                .arg(ss, 2, 10, QChar('0'));
+
+        int frameNumber =
+            (hh * 3600) + (mm * 60) + ss + 1;
+
+
+        /* -------------------------
+           DEST LOCO ID (bits 49–68)
+           ------------------------- */
+        QString locoId =
+            QString::number(bits(49, 20));
+
+        /* -------------------------
+           PROFILE ID (bits 69–72)
+           ------------------------- */
+        QString profileId =
+            QString::number(bits(69, 4));
+
+        /* -------------------------
+           SUB PROFILE COUNT (bits 269–275)
+           ------------------------- */
+        QString subProfileCount =
+            QString::number(bits(269, 7));
+        /* -------------------------
+           PROFILE LENGTH (bits 264–270)
+           ------------------------- */
+        QString profileLength =
+            QString::number(bits(264, 7));
+
+        /* -------------------------
+           FINAL ROW (DESKTOP FORMAT)
+           ------------------------- */
+        QJsonObject row;
+        row["date"]              = date;
+        row["time"]              = time;
+        row["frameNumber"]       = frameNumber;
+        row["stationId"]         = stationId;
+        row["locoId"]            = locoId;
+        row["profileId"]         = profileId;
+        row["subProfileCount"]   = subProfileCount;
+        row["subProfileId"]      = "-";
+        row["startLocation"]     = "-";
+        row["profileLength"]     = profileLength;
+
+        rows.append(row);
+    };
 
+    // Days are decoded concurrently, rows merged in date order
+    const QVector<QJsonArray> days = LogParallel::scanDays<QJsonArray>(
+        LogParallel::dayPaths(cleanLogDir, from, to),
+        [&](LogScanner &scanner, QJsonArray &dayRows, int)
+    {
+        scanner.on(0x11, [&](const LogPacket &pkt) { onPacket(pkt, dayRows); });
+    });
+
+    for (const QJsonArray &dayRows : days)
+        for (const QJsonValue &row : dayRows)
             rows.append(row);
-            hasData = true;
-        }
-    }
+
+    hasData = !rows.isEmpty();
 
     return {
         {"success", true},